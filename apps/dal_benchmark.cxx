@@ -0,0 +1,323 @@
+//
+//  FILE: src/dal_benchmark.cpp
+//
+//  Measure latency and throughput of the DAL algorithms on given partition,
+//  e.g. generated by dal_generate_partition.py script:
+//    - get_segment() building segments tree from scratch
+//    - get_all_applications() of built tree
+//    - disabled() of all components with empty and with filled cache
+//    - get_info() of all applications
+//    - SubstituteVariables::reset()
+//    - get_used_repositories()
+//    - type tests of all resources using DalObject::cast() and ClassMask
+//      (use large resource tree, e.g. --resource-depth and --resource-width
+//      options of the generator)
+//
+//  For command line arguments run the program with --help.
+//
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "oksdbinterfaces/Configuration.hpp"
+
+#include "dal/BaseApplication.hpp"
+#include "dal/Component.hpp"
+#include "dal/OnlineSegment.hpp"
+#include "dal/Partition.hpp"
+#include "dal/ResourceBase.hpp"
+#include "dal/ResourceSet.hpp"
+#include "dal/Segment.hpp"
+#include "dal/TemplateApplication.hpp"
+
+#include "dal/class-mask.hpp"
+#include "dal/instrumentation.hpp"
+#include "dal/partition-image.hpp"
+#include "dal/util.hpp"
+
+
+using namespace dunedaq::oksdbinterfaces;
+
+
+  // run the test given number of times and report latency of single run and throughput of operations
+
+struct Benchmark
+{
+  std::string m_name;
+  std::function<void()> m_prepare;    // not measured
+  std::function<size_t()> m_run;      // return number of operations
+};
+
+static void
+report_header(bool csv)
+{
+  if (csv)
+    std::cout << "algorithm,iterations,operations,min_ms,median_ms,max_ms,ops_per_s\n";
+  else
+    std::cout << std::left << std::setw(40) << "algorithm" << std::right << std::setw(8) << "iter" << std::setw(10) << "ops" << std::setw(12) << "min ms" << std::setw(12) << "median ms" << std::setw(12) << "max ms" << std::setw(14) << "ops/s" << std::endl;
+}
+
+static void
+run(const Benchmark& b, unsigned int iterations, bool csv)
+{
+  std::vector<double> latency;
+  latency.reserve(iterations);
+
+  size_t num = 0;
+
+  for (unsigned int i = 0; i < iterations; ++i)
+    {
+      if (b.m_prepare)
+        b.m_prepare();
+
+      auto tp = std::chrono::steady_clock::now();
+      num = b.m_run();
+      latency.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tp).count() / 1000000.);
+    }
+
+  std::sort(latency.begin(), latency.end());
+
+  const double median = latency[latency.size() / 2];
+  const double ops_per_s = (median > 0 ? num * 1000. / median : 0);
+
+  if (csv)
+    std::cout << b.m_name << ',' << iterations << ',' << num << ',' << latency.front() << ',' << median << ',' << latency.back() << ',' << ops_per_s << std::endl;
+  else
+    std::cout << std::left << std::setw(40) << b.m_name << std::right << std::setw(8) << iterations << std::setw(10) << num << std::fixed << std::setprecision(3) << std::setw(12) << latency.front() << std::setw(12) << median << std::setw(12) << latency.back() << std::setprecision(0) << std::setw(14) << ops_per_s << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+  boost::program_options::options_description desc("Measure latency and throughput of DAL algorithms. The latency is reported for single iteration; the throughput is number of operations (e.g. applications or components) processed per second by median iteration.");
+
+  std::string db_name;
+  std::string partition_name;
+  std::vector<std::string> tests;
+  unsigned int iterations = 10;
+
+  bool subst = false;
+  bool csv = false;
+  bool instrumentation = false;
+
+  try
+    {
+      desc.add_options()
+        ("data,d", boost::program_options::value<std::string>(&db_name)->required(), "name of the database")
+        ("partition-id,p", boost::program_options::value<std::string>(&partition_name)->required(), "name of the partition object")
+        ("iterations,n", boost::program_options::value<unsigned int>(&iterations)->default_value(iterations), "number of iterations of each test")
+        ("tests,t", boost::program_options::value<std::vector<std::string>>(&tests)->multitoken(), "run these tests only (get_segment, get_all_applications, disabled_cold, disabled_warm, get_info, reset_variables, get_used_repositories, cast_resources, class_mask_resources)")
+        ("substitute-variables,s", "substitute database parameters")
+        ("csv,c", "print results in CSV format")
+        ("instrumentation,I", "print counters, timers and heap allocations of DAL algorithms after each test (if the library is built with instrumentation)")
+        ("help,h", "Print help message");
+
+      boost::program_options::variables_map vm;
+      boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help"))
+        {
+          std::cout << desc << std::endl;
+          return EXIT_SUCCESS;
+        }
+
+      boost::program_options::notify(vm);
+
+      if (vm.count("substitute-variables"))
+        subst = true;
+
+      if (vm.count("csv"))
+        csv = true;
+
+      if (vm.count("instrumentation"))
+        instrumentation = true;
+
+      if (iterations == 0)
+        iterations = 1;
+    }
+  catch (std::exception& ex)
+    {
+      std::cerr << "Command line parsing errors occurred:\n" << ex.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // attribute heap allocations of this thread to the instrumentation probes
+
+  std::unique_ptr<dunedaq::dal::Instrumentation::AllocationScope> allocation_scope(instrumentation ? new dunedaq::dal::Instrumentation::AllocationScope() : nullptr);
+
+  try
+    {
+      auto tp = std::chrono::steady_clock::now();
+
+      Configuration conf(db_name);
+
+      const dunedaq::dal::Partition * partition = dunedaq::dal::get_partition(conf, partition_name);
+
+      if (!partition)
+        return EXIT_FAILURE;
+
+      dunedaq::dal::SubstituteVariables * converter = nullptr;
+
+      if (subst)
+        {
+          converter = new dunedaq::dal::SubstituteVariables(*partition);
+          conf.register_converter(converter);
+        }
+
+      std::vector<const dunedaq::dal::Component *> components;
+      conf.get(components);
+
+      const std::string& online_id(partition->get_OnlineInfrastructure()->UID());
+      const std::shared_ptr<const dunedaq::dal::PartitionImage> image_ptr(partition->get_image()); // keeps the image arrays alive on reload
+      const dunedaq::dal::PartitionImage& image(*image_ptr);
+
+      if (!csv)
+        std::cout << "partition " << partition_name << " loaded in " << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tp).count() / 1000. << " ms: "
+                  << image.get_num_of_segments() << " segments, " << image.get_num_of_applications() << " applications, " << components.size() << " components, "
+                  << image.get_hosts().size() << " hosts\n\n";
+
+      // reset cached segments tree and disabled components
+
+      auto reset = [partition]()
+        {
+          partition->set_disabled(std::set<const dunedaq::dal::Component *>());
+        };
+
+      std::vector<Benchmark> benchmarks;
+
+      benchmarks.push_back(Benchmark{"get_segment", reset, [&]()
+        {
+          partition->get_segment(online_id);
+          return partition->get_image()->get_num_of_applications();
+        }});
+
+      benchmarks.push_back(Benchmark{"get_all_applications", nullptr, [&]()
+        {
+          return partition->get_all_applications().size();
+        }});
+
+      benchmarks.push_back(Benchmark{"disabled_cold", reset, [&]()
+        {
+          for (const auto& x : components)
+            x->disabled(*partition);
+          return components.size();
+        }});
+
+      benchmarks.push_back(Benchmark{"disabled_warm", nullptr, [&]()
+        {
+          for (const auto& x : components)
+            x->disabled(*partition);
+          return components.size();
+        }});
+
+      benchmarks.push_back(Benchmark{"get_info", nullptr, [&]()
+        {
+          std::vector<const dunedaq::dal::BaseApplication *> apps = partition->get_all_applications();
+
+          for (const auto& x : apps)
+            {
+              std::map<std::string, std::string> environment;
+              std::vector<std::string> program_names;
+              std::string start_args, restart_args;
+              x->get_info(environment, program_names, start_args, restart_args);
+            }
+
+          return apps.size();
+        }});
+
+      if (converter)
+        benchmarks.push_back(Benchmark{"reset_variables", nullptr, [&]()
+          {
+            converter->reset(*partition);
+            return static_cast<size_t>(1);
+          }});
+
+      benchmarks.push_back(Benchmark{"get_used_repositories", nullptr, [&]()
+        {
+          return dunedaq::dal::get_used_repositories(*partition).size();
+        }});
+
+      // type tests made by disabled() and get_resource_applications() for every resource
+
+      std::vector<const dunedaq::dal::ResourceBase *> resources;
+      conf.get(resources);
+
+      const size_t not_run = static_cast<size_t>(-1);
+      size_t cast_matches = not_run, mask_matches = not_run;
+
+      benchmarks.push_back(Benchmark{"cast_resources", nullptr, [&]()
+        {
+          size_t num = 0;
+
+          for (const auto& x : resources)
+            {
+              if (x->cast<dunedaq::dal::ResourceSet>() != nullptr)
+                num++;
+              if (x->cast<dunedaq::dal::TemplateApplication>() != nullptr)
+                num++;
+            }
+
+          cast_matches = num;
+          return resources.size();
+        }});
+
+      benchmarks.push_back(Benchmark{"class_mask_resources", nullptr, [&]()
+        {
+          size_t num = 0;
+
+          for (const auto& x : resources)
+            {
+              if (dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(x) != nullptr)
+                num++;
+              if (dunedaq::dal::ClassMask::castable<dunedaq::dal::TemplateApplication>(x))
+                num++;
+            }
+
+          mask_matches = num;
+          return resources.size();
+        }});
+
+      report_header(csv);
+
+      for (const auto& b : benchmarks)
+        if (tests.empty() || std::find(tests.begin(), tests.end(), b.m_name) != tests.end())
+          {
+            if (instrumentation)
+              dunedaq::dal::Instrumentation::reset();
+
+            run(b, iterations, csv);
+
+            if (instrumentation)
+              {
+                dunedaq::dal::Instrumentation::print(std::cout);
+                std::cout << std::endl;
+              }
+          }
+
+      if (cast_matches != not_run && mask_matches != not_run && cast_matches != mask_matches)
+        {
+          std::cerr << "ERROR: type tests using cast() and ClassMask differ: " << cast_matches << " vs. " << mask_matches << " matches" << std::endl;
+          return EXIT_FAILURE;
+        }
+    }
+  catch (ers::Issue & ex)
+    {
+      std::cerr << "Caught " << ex << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,218 @@
+//
+//  FILE: src/dal_diff_apps.cpp
+//
+//  Compare launch descriptions of applications between two configurations
+//  of a partition and report applications to be restarted:
+//    - the application is added or removed
+//    - the application's host, backup hosts, program names, command line
+//      arguments or environment are changed
+//
+//  For command line arguments see function usage() or run the program
+//  with --help.
+//
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "oksdbinterfaces/Configuration.hpp"
+
+#include "dal/Partition.hpp"
+
+#include "dal/app-info-cache.hpp"
+#include "dal/launch-diff.hpp"
+#include "dal/launch-plan.hpp"
+#include "dal/util.hpp"
+
+
+using namespace dunedaq::oksdbinterfaces;
+
+
+  // get launch plan from snapshot or compute it from the database
+
+static std::unique_ptr<dunedaq::dal::LaunchPlan>
+get_plan(const std::string& db_name, const std::string& version, const std::string& partition_name, bool subst, const std::string& snapshot_dir, const std::string& info_cache_dir)
+{
+  std::string plan_file;
+  const std::string inputs(dunedaq::dal::LaunchPlan::make_inputs(db_name));
+
+  if (!snapshot_dir.empty() && !version.empty())
+    {
+      plan_file = dunedaq::dal::LaunchPlan::get_file_name(snapshot_dir, partition_name, version, subst, inputs);
+
+      try
+        {
+          if (std::unique_ptr<dunedaq::dal::LaunchPlan> plan = dunedaq::dal::LaunchPlan::open(plan_file, partition_name, version, subst, inputs))
+            return plan;
+        }
+      catch (ers::Issue & ex)
+        {
+          ers::warning(ex);
+        }
+    }
+
+  if (db_name.empty())
+    throw std::runtime_error(std::string("there is no launch plan of version \'") + version + "\' and the database is not defined");
+
+  // the database is loaded at the version defined by the process environment (TDAQ_DB_VERSION);
+  // the plan of another version can only be read from snapshot and it is never written under such version
+
+  if (!version.empty())
+    {
+      std::string loaded_version;
+
+      try
+        {
+          loaded_version = dunedaq::dal::get_config_version(partition_name);
+        }
+      catch (ers::Issue &)
+        {
+          ;
+        }
+
+      if (version != loaded_version)
+        throw std::runtime_error(
+          std::string("there is no launch plan of version \'") + version + "\' and the database \'" + db_name + "\' is loaded at " +
+          (loaded_version.empty() ? std::string("unknown version (TDAQ_DB_VERSION is not defined)") : std::string("version \'") + loaded_version + '\'')
+        );
+    }
+
+  // without snapshots directory use temporary file, that is removed after it is mapped
+
+  const bool temporary = plan_file.empty();
+
+  if (temporary)
+    {
+      char name[] = "/tmp/dal-diff-apps.XXXXXX";
+      int fd = mkstemp(name);
+
+      if (fd < 0)
+        throw std::runtime_error("cannot create temporary file");
+
+      close(fd);
+      plan_file = name;
+    }
+
+  Configuration conf(db_name);
+
+  const dunedaq::dal::Partition * partition = dunedaq::dal::get_partition(conf, partition_name);
+
+  if (!partition)
+    throw std::runtime_error(std::string("cannot find partition \'") + partition_name + "\' in database \'" + db_name + '\'');
+
+  if (subst)
+    conf.register_converter(new dunedaq::dal::SubstituteVariables(*partition));
+
+  // the cache entries are addressed by dependencies contents, so unchanged applications are not recomputed
+
+  std::unique_ptr<dunedaq::dal::AppInfoCache> info_cache;
+
+  if (!info_cache_dir.empty())
+    info_cache.reset(new dunedaq::dal::AppInfoCache(conf, info_cache_dir, subst ? "subst" : "raw"));
+
+  std::unique_ptr<dunedaq::dal::LaunchPlan> plan;
+
+  try
+    {
+      dunedaq::dal::LaunchPlan::write(plan_file, *partition, version, subst, inputs, info_cache.get());
+      plan = dunedaq::dal::LaunchPlan::open(plan_file, partition_name, version, subst, inputs);
+    }
+  catch (...)
+    {
+      if (temporary)
+        unlink(plan_file.c_str());
+
+      throw;
+    }
+
+  if (temporary)
+    unlink(plan_file.c_str());
+
+  return plan;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+  boost::program_options::options_description desc("Compare launch descriptions of applications between two configurations of the partition and print applications to be restarted.");
+
+  std::string from_db_name, to_db_name;
+  std::string from_version, to_version;
+  std::string partition_name;
+  std::string snapshot_dir;
+  std::string info_cache_dir;
+
+  bool subst = false;
+  bool names_only = false;
+
+  try
+    {
+      desc.add_options()
+        ("from-data,f", boost::program_options::value<std::string>(&from_db_name), "name of the running configuration database")
+        ("from-version,F", boost::program_options::value<std::string>(&from_version), "version of the running configuration; the plan is read from snapshot or computed from the database, if it is loaded at this version (TDAQ_DB_VERSION)")
+        ("to-data,t", boost::program_options::value<std::string>(&to_db_name), "name of the new configuration database")
+        ("to-version,T", boost::program_options::value<std::string>(&to_version), "version of the new configuration; the plan is read from snapshot or computed from the database, if it is loaded at this version (TDAQ_DB_VERSION)")
+        ("partition-id,p", boost::program_options::value<std::string>(&partition_name)->required(), "name of the partition object")
+        ("substitute-variables,s", "substitute database parameters")
+        ("snapshot-dir", boost::program_options::value<std::string>(&snapshot_dir), "directory of launch plan snapshots; read plans of given versions from it or create them")
+        ("info-cache-dir", boost::program_options::value<std::string>(&info_cache_dir), "directory of persistent cache of applications info; unchanged applications are not recomputed")
+        ("names-only,n", "print identities of applications to be restarted only")
+        ("help,h", "Print help message");
+
+      boost::program_options::variables_map vm;
+      boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help"))
+        {
+          std::cout << desc << std::endl;
+          return EXIT_SUCCESS;
+        }
+
+      boost::program_options::notify(vm);
+
+      if (vm.count("substitute-variables"))
+        subst = true;
+
+      if (vm.count("names-only"))
+        names_only = true;
+    }
+  catch (std::exception& ex)
+    {
+      std::cerr << "Command line parsing errors occurred:\n" << ex.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  try
+    {
+      std::unique_ptr<dunedaq::dal::LaunchPlan> from = get_plan(from_db_name, from_version, partition_name, subst, snapshot_dir, info_cache_dir);
+      std::unique_ptr<dunedaq::dal::LaunchPlan> to = get_plan(to_db_name, to_version, partition_name, subst, snapshot_dir, info_cache_dir);
+
+      for (const auto& x : dunedaq::dal::compare_launch_plans(*from, *to))
+        {
+          if (names_only)
+            std::cout << x.m_id << std::endl;
+          else
+            x.print(std::cout);
+        }
+    }
+  catch (ers::Issue & ex)
+    {
+      std::cerr << "Caught " << ex << std::endl;
+      return EXIT_FAILURE;
+    }
+  catch (std::exception & ex)
+    {
+      std::cerr << "ERROR: " << ex.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -17,6 +17,7 @@
 //
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -29,6 +30,10 @@
 #include "dal/OnlineSegment.hpp"
 #include "dal/Partition.hpp"
 
+#include "dal/app-info-cache.hpp"
+#include "dal/instrumentation.hpp"
+#include "dal/launch-options.hpp"
+#include "dal/launch-plan.hpp"
 #include "dal/util.hpp"
 
 
@@ -74,6 +79,71 @@ print_info(const std::vector<std::string>& file_names, const std::map<std::strin
     }
 }
 
+  // return false, if the application object is not used by the partition:
+  // the snapshot does not tell if such object exists, so the database has to be checked
+
+static bool
+dump_launch_plan(const dunedaq::dal::LaunchPlan& plan, const std::string& object_id, const std::string& app_name, const std::string& segment_id)
+{
+  unsigned int count = 0;
+
+  for (uint32_t idx = 0; idx < plan.get_num_of_applications(); ++idx)
+    {
+      const dunedaq::dal::LaunchPlan::ApplicationRecord& i(plan.get_application(idx));
+
+      if (!segment_id.empty() && segment_id != plan.get_string(plan.get_segment(i.m_segment).m_id))
+        continue;
+      if (!object_id.empty() && object_id != plan.get_string(i.m_base_app_id))
+        continue;
+      if (!app_name.empty() && app_name != plan.get_string(i.m_id))
+        continue;
+
+      count++;
+
+      if (i.m_templated == false)
+        {
+          std::cout << "### (" << count << ") application " << plan.get_string(i.m_base_app_name) << " ###\n";
+        }
+      else
+        {
+          std::cout << "### (" << count << ") template application " << plan.get_string(i.m_id) << " ###\n";
+        }
+
+      std::cout << " - command line start args:\n    " << plan.get_string(i.m_start_args) << "\n - command line restart args:\n    " << plan.get_string(i.m_restart_args) << std::endl;
+
+      print_info(plan.get_program_names(i), plan.get_environment(i));
+    }
+
+  if (count == 0)
+    {
+      if (!object_id.empty())
+        return false;
+      else if (!app_name.empty())
+        std::cout << "the application with name \'" << app_name << "\' is not running in the partition; it is disabled or not included into partition\n";
+      else if (!segment_id.empty())
+        std::cout << "the applications of segment " << segment_id << " are not running in the partition; the segment or it\'s applications are disabled or the segment is not included into partition\n";
+    }
+
+  return true;
+}
+
+  // print reports requested by command line; the paths are not pruned, if the launch plan is read from snapshot
+
+static void
+print_reports(bool prune_paths, bool instrumentation, const dunedaq::dal::LaunchPlan * snapshot)
+{
+  if (prune_paths)
+    {
+      if (snapshot)
+        std::cout << "the paths were pruned when the launch plan snapshot " << snapshot->get_file_name() << " was written\n";
+      else
+        dunedaq::dal::LaunchOptions::print(std::cout);
+    }
+
+  if (instrumentation)
+    dunedaq::dal::Instrumentation::print(std::cout);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -84,8 +154,13 @@ main(int argc, char *argv[])
   std::string object_id;
   std::string app_name;
   std::string segment_id;
+  std::string snapshot_dir;
+  std::string info_cache_dir;
+  std::string library_view_dir;
 
   bool subst = false;
+  bool instrumentation = false;
+  bool prune_paths = false;
 
 
   try
@@ -97,6 +172,12 @@ main(int argc, char *argv[])
         ("application-name,n", boost::program_options::value<std::string>(&app_name), "name of the application object (if not provided, dump all applications)")
         ("application-segment-id,g", boost::program_options::value<std::string>(&segment_id), "identity of the application's segment object (if defined, print apps of this segment)")
         ("substitute-variables,s","substitute database parameters")
+        ("snapshot-dir", boost::program_options::value<std::string>(&snapshot_dir), "directory of launch plan snapshots; if defined, read the plan for the partition, configuration version (TDAQ_DB_VERSION), database name, repository environment and launch options without loading the database, or create it")
+        ("info-cache-dir", boost::program_options::value<std::string>(&info_cache_dir), "directory of persistent cache of applications info; if defined, read applications info from it or update it (also when the launch plan snapshot is created)")
+        ("instrumentation,I", "print counters, timers and heap allocations of DAL algorithms (if the library is built with instrumentation)")
+        ("prune-paths,P", "remove non-existent and empty directories from PATH and LD_LIBRARY_PATH and report how many were removed")
+        ("resolve-programs,R", "return the first executable program file instead of all candidate program names")
+        ("library-view-dir", boost::program_options::value<std::string>(&library_view_dir), "local directory of shared libraries views; if defined, replace directories of LD_LIBRARY_PATH by single view directory")
         ("help,h", "Print help message");
 
       boost::program_options::variables_map vm;
@@ -114,6 +195,27 @@ main(int argc, char *argv[])
         {
           subst = true;
         }
+
+      if (vm.count("instrumentation"))
+        {
+          instrumentation = true;
+        }
+
+      if (vm.count("prune-paths"))
+        {
+          prune_paths = true;
+          dunedaq::dal::LaunchOptions::set(dunedaq::dal::LaunchOptions::PrunePaths);
+        }
+
+      if (vm.count("resolve-programs"))
+        {
+          dunedaq::dal::LaunchOptions::set(dunedaq::dal::LaunchOptions::ResolvePrograms);
+        }
+
+      if (!library_view_dir.empty())
+        {
+          dunedaq::dal::LaunchOptions::set_library_view_dir(library_view_dir);
+        }
     }
   catch (std::exception& ex)
     {
@@ -122,6 +224,43 @@ main(int argc, char *argv[])
     }
 
 
+    // attribute heap allocations of this thread to the instrumentation probes
+
+  std::unique_ptr<dunedaq::dal::Instrumentation::AllocationScope> allocation_scope(instrumentation ? new dunedaq::dal::Instrumentation::AllocationScope() : nullptr);
+
+    // use launch plan snapshot, if available
+
+  std::unique_ptr<dunedaq::dal::LaunchPlan> plan;
+  std::string plan_file, config_version, inputs;
+
+  if (!snapshot_dir.empty())
+    {
+      try
+        {
+          config_version = dunedaq::dal::get_config_version(partition_name);
+          inputs = dunedaq::dal::LaunchPlan::make_inputs(db_name);
+          plan_file = dunedaq::dal::LaunchPlan::get_file_name(snapshot_dir, partition_name, config_version, subst, inputs);
+          plan = dunedaq::dal::LaunchPlan::open(plan_file, partition_name, config_version, subst, inputs);
+        }
+      catch (ers::Issue & ex)
+        {
+          ers::warning(ex);
+        }
+
+      if (plan)
+        {
+          if (dump_launch_plan(*plan, object_id, app_name, segment_id))
+            {
+              print_reports(prune_paths, instrumentation, plan.get());
+              return EXIT_SUCCESS;
+            }
+
+          // the snapshot is valid, check the application object in the database
+          plan_file.clear();
+        }
+    }
+
+
     // work with configuration
 
   try
@@ -145,6 +284,43 @@ main(int argc, char *argv[])
           conf.register_converter(new dunedaq::dal::SubstituteVariables(*partition));
         }
 
+      // create persistent cache of applications info
+
+      std::unique_ptr<dunedaq::dal::AppInfoCache> info_cache;
+
+      if (!info_cache_dir.empty())
+        {
+          try
+            {
+              info_cache.reset(new dunedaq::dal::AppInfoCache(conf, info_cache_dir, subst ? "subst" : "raw"));
+            }
+          catch (ers::Issue & ex)
+            {
+              ers::warning(ex);
+            }
+        }
+
+      // create launch plan snapshot
+
+      if (!plan_file.empty())
+        {
+          try
+            {
+              dunedaq::dal::LaunchPlan::write(plan_file, *partition, config_version, subst, inputs, info_cache.get());
+              plan = dunedaq::dal::LaunchPlan::open(plan_file, partition_name, config_version, subst, inputs);
+            }
+          catch (ers::Issue & ex)
+            {
+              ers::warning(ex);
+            }
+
+          if (plan && dump_launch_plan(*plan, object_id, app_name, segment_id))
+            {
+              print_reports(prune_paths, instrumentation, nullptr);
+              return EXIT_SUCCESS;
+            }
+        }
+
       // get application object (a normal application or template application)
 
       const dunedaq::dal::BaseApplication * b_app = (object_id.empty() ? nullptr : conf.get<dunedaq::dal::BaseApplication>(object_id));
@@ -195,7 +371,11 @@ main(int argc, char *argv[])
               std::vector<std::string> file_names;
               std::map<std::string, std::string> environment;
               std::string a, b;
-              i->get_info(environment, file_names, a, b);
+
+              if (info_cache)
+                info_cache->get_info(*i, environment, file_names, a, b);
+              else
+                i->get_info(environment, file_names, a, b);
 
               std::cout << " - command line start args:\n    " << a << "\n - command line restart args:\n    " << b << std::endl;
 
@@ -216,6 +396,8 @@ main(int argc, char *argv[])
           else if (!segment_id.empty())
             std::cout << "the applications of segment " << segment_id << " are not running in the partition; the segment or it\'s applications are disabled or the segment is not included into partition\n";
         }
+
+      print_reports(prune_paths, instrumentation, nullptr);
     }
   catch (ers::Issue & ex)
     {
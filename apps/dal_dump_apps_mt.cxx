@@ -1,194 +1,280 @@
 //
-//  FILE: src/dal_dump_apps.cpp
+//  FILE: src/dal_dump_apps_mt.cpp
 //
-//  Example program which shows how to use user-defined algorithms
-//  in the user's code. In particular:
-//    - find root partition
-//    - calculate application's program, command line, environment,
-//      binary search paths and paths to shared libraries.
+//  Multi-threaded stress test of the DAL algorithms. For each requested
+//  number of threads the program runs configurable mix of operations:
+//    - get_segment() of online segment
+//    - get_all_applications() of partition
+//    - disabled() of a component
+//    - get_info() of an application
+//    - reload notification (the segments tree and disabled components are
+//      reset as on configuration change)
 //
-//  For command line arguments see function usage() or run the program
-//  with --help.
+//  Every result is compared with the reference calculated serially before
+//  the test. The program reports throughput, p50 / p99 latency of each
+//  operation inside the library, mean time spent waiting for the reload
+//  lock of the test and scaling efficiency.
+//  The exit status is non-zero, if any result differs from the reference.
+//
+//  The reload is exclusive, since get_segment() and get_all_applications()
+//  return objects of the segments tree destroyed by reload. By default all
+//  other operations wait for it too. With --concurrent-reload the disabled()
+//  and get_info() of applications defined by the database (not generated by
+//  the tree) do not take the lock of the test, so the reload overlaps with
+//  them and the synchronization of the library itself is tested.
+//
+//  To see how the threads interleave, set DAL_TRACE_FILE environment variable
+//  to a file name; the algorithms spans are written there in Chrome
+//  trace-event format.
+//
+//  For command line arguments run the program with --help.
 //
 //  Implementation:
 //	<Igor.Soloviev@cern.ch> - May 2003
 //
 
 #include <stdlib.h>
-#include <thread>
-#include <fstream>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <shared_mutex>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/program_options.hpp>
 
 #include "oksdbinterfaces/Configuration.hpp"
 
 #include "dal/BaseApplication.hpp"
+#include "dal/Component.hpp"
 #include "dal/OnlineSegment.hpp"
 #include "dal/Partition.hpp"
 #include "dal/Segment.hpp"
+#include "dal/Tag.hpp"
+#include "dal/instrumentation.hpp"
 #include "dal/util.hpp"
 
 using namespace dunedaq::oksdbinterfaces;
 
-static void
-print_info(
-  const std::vector<std::string>& file_names,
-  const std::map<std::string, std::string>& environment,
-  std::ostream& f
-)
-{
 
-    // print program names
+enum Operation {
+  GetSegment,
+  GetAllApplications,
+  Disabled,
+  GetInfo,
+  Reload,
+  NumOfOperations
+};
 
-  f << " - possible program file names:";
+static const char * s_operation_names[NumOfOperations] = { "get_segment", "get_all_applications", "disabled", "get_info", "reload" };
 
-  if(file_names.empty()) {
-    f << " no\n";
-  }
-  else {
-    f << std::endl;
-    for(std::vector<std::string>::const_iterator j = file_names.begin(); j != file_names.end(); ++j) {
-      f << "    * " << *j << std::endl;
-    }
-  }
 
+  // results of operations calculated serially
 
-    // print environment
+struct Reference
+{
+  std::string m_online_segment_id;
+  std::vector<std::string> m_applications;
+  std::vector<const dunedaq::dal::Component *> m_components;
+  std::vector<bool> m_disabled;
+  std::unordered_map<std::string, std::string> m_info;
+  std::vector<const dunedaq::dal::BaseApplication *> m_db_applications;  // not generated by the segments tree
+};
 
-  f << " - environment variables:";
 
-  if(environment.empty()) {
-    f << " no\n";
-  }
-  else {
-    f << std::endl;
-    for(std::map<std::string, std::string>::const_iterator j = environment.begin(); j != environment.end(); ++j) {
-      f << "    * " << j->first << "=\"" << j->second << "\"\n";
-    }
-  }
-}
+  // statistics of single thread
 
-static void
-get_configuration(Configuration& db, const std::string& partition_name, const std::string& object_id, const std::string& app_name, const std::string& segment_id, bool subst, int count)
+struct ThreadStatistics
 {
-  try {
-      // find partition || exit, if there is no partition object
-
-    const dunedaq::dal::Partition * partition = dunedaq::dal::get_partition(db, partition_name);
-    if(!partition) return;
+  std::vector<double> m_latency[NumOfOperations];   // microseconds
+  double m_lock_wait[NumOfOperations] = {};          // microseconds
+  uint64_t m_errors = 0;
+  std::string m_first_error;
+};
 
-    std::ostringstream fname;
-    fname << "/tmp/test-" << count << ".out";
-    std::ofstream f(fname.str());
 
-      // register variables converter
+static std::string
+get_info(const dunedaq::dal::BaseApplication& app)
+{
+  std::map<std::string, std::string> environment;
+  std::vector<std::string> file_names;
+  std::string start_args, restart_args;
 
-    if(subst) {
-      db.register_converter(new dunedaq::dal::SubstituteVariables(*partition));
-    }
+  std::ostringstream s;
 
+  try
+    {
+      const dunedaq::dal::Tag * tag = app.get_info(environment, file_names, start_args, restart_args);
 
-      // get application object (a normal application or template application)
+      s << tag->UID() << '\n' << start_args << '\n' << restart_args << '\n';
 
-    const dunedaq::dal::BaseApplication * b_app = (object_id.empty() ? 0 : db.get<dunedaq::dal::BaseApplication>(object_id));
+      for (const auto& x : file_names)
+        s << x << '\n';
 
-    if(!object_id.empty() && !b_app) {
-      f << "ERROR: cannot get object \'" << object_id << "\' of class \'BaseApplication\'\n";
-      return;
+      for (const auto& x : environment)
+        s << x.first << '=' << x.second << '\n';
+    }
+  catch (dunedaq::dal::AlgorithmError & ex)
+    {
+      s << "ERROR: " << ex.message();
     }
 
+  return s.str();
+}
 
-      // get application(s)
+static std::vector<std::string>
+get_applications(const dunedaq::dal::Partition& partition)
+{
+  std::vector<std::string> out;
 
-    std::set<std::string> segments;
+  for (const auto& x : partition.get_all_applications())
+    out.push_back(x->UID());
 
-    if(!segment_id.empty()) {
-      segments.insert(segment_id);
-    }
+  return out;
+}
 
-    const dunedaq::dal::Segment * root_seg = partition->get_segment(partition->get_OnlineInfrastructure()->UID());
-    std::vector<const dunedaq::dal::BaseApplication *> objects = root_seg->get_all_applications(nullptr, (!segments.empty() ? &segments : nullptr), nullptr);
+static void
+reload(const dunedaq::dal::Partition& partition)
+{
+  partition.set_disabled(std::set<const dunedaq::dal::Component *>());
+}
 
-    unsigned int count = 0;
+static void
+run_thread(const dunedaq::dal::Partition& partition, const Reference& ref, const std::vector<unsigned int>& weights, unsigned int operations, unsigned int seed, std::shared_mutex& reload_mutex, bool concurrent_reload, ThreadStatistics& stat)
+{
+  std::mt19937 rnd(seed);
+  std::discrete_distribution<int> choose_operation(weights.begin(), weights.end());
 
-    for (const auto& i : objects) {
-      if(b_app && (i->get_base_app()->cast<dunedaq::dal::BaseApplication>() != b_app)) continue;
-      if(!app_name.empty() && app_name != i->UID()) continue;
+  auto error = [&stat](const std::string& text)
+    {
+      if (stat.m_errors++ == 0)
+        stat.m_first_error = text;
+    };
 
-      count++;
+  for (unsigned int i = 0; i < operations; ++i)
+    {
+      const int op = choose_operation(rnd);
 
-      if(i->is_templated()) {
-        f << "### (" << count << ") template application " << i << " ###" << std::endl;
-      }
-      else {
-        f << "### (" << count << ") application " << i << " ###" << std::endl;
-      }
+      auto tp = std::chrono::steady_clock::now();
 
-        // get application parameters (tag, environment set, application host,
-        // possible program names, paths to programs and shared libs)
+      // the reload is exclusive, since it destroys the segments tree used by other threads;
+      // in concurrent mode the operations not holding objects of the tree do not take the lock
 
-      try {
-        std::vector<std::string> file_names;
-        std::map<std::string, std::string> environment;
-        std::string a, b;
+      std::shared_lock<std::shared_mutex> shared(reload_mutex, std::defer_lock);
+      std::unique_lock<std::shared_mutex> exclusive(reload_mutex, std::defer_lock);
 
-        (*i).get_info(environment, file_names, a, b) ;
+      const bool holds_tree = (op == GetSegment || op == GetAllApplications || (op == GetInfo && !concurrent_reload));
 
-        f << " - command line start args:\n    " << a << "\n"
-             " - command line restart args:\n    " << b << std::endl;
+      if (op == Reload)
+        exclusive.lock();
+      else if (holds_tree || !concurrent_reload)
+        shared.lock();
 
-        print_info(file_names, environment, f);
-      }
-      catch ( dunedaq::dal::AlgorithmError & ex ) {
-        ers::error( ex ) ;  // report a problem
-      }
-    }
+      auto tp2 = std::chrono::steady_clock::now();
+      stat.m_lock_wait[op] += std::chrono::duration_cast<std::chrono::nanoseconds>(tp2 - tp).count() / 1000.;
 
-    if(count == 0) {
-      if(b_app) {
-        f << "the application " << b_app << " is not running in the partition; it is disabled or not included into partition" << std::endl;
-      }
-      else if(!app_name.empty()) {
-        f << "the application with name \'" << app_name << "\' is not running in the partition; it is disabled or not included into partition" << std::endl;
-      }
-      else if(!segment_id.empty()) {
-        f << "the applications of segment " << segment_id << " are not running in the partition; the segment or it\'s applications are disabled or the segment is not included into partition" << std::endl;
-      }
+      try
+        {
+          switch (op)
+            {
+              case GetSegment:
+                if (partition.get_segment(ref.m_online_segment_id)->UID() != ref.m_online_segment_id)
+                  error("get_segment() returned wrong segment");
+                break;
+
+              case GetAllApplications:
+                if (get_applications(partition) != ref.m_applications)
+                  error("get_all_applications() result differs from reference");
+                break;
+
+              case Disabled:
+                if (!ref.m_components.empty())
+                  {
+                    const size_t idx = rnd() % ref.m_components.size();
+
+                    if (ref.m_components[idx]->disabled(partition) != ref.m_disabled[idx])
+                      error(std::string("disabled() result differs from reference for ") + ref.m_components[idx]->UID());
+                  }
+                break;
+
+              case GetInfo:
+                {
+                  const std::vector<const dunedaq::dal::BaseApplication *> apps = (concurrent_reload ? ref.m_db_applications : partition.get_all_applications());
+
+                  if (!apps.empty())
+                    {
+                      const dunedaq::dal::BaseApplication * app = apps[rnd() % apps.size()];
+                      auto it = ref.m_info.find(app->UID());
+
+                      if (it == ref.m_info.end() || it->second != get_info(*app))
+                        error(std::string("get_info() result differs from reference for ") + app->UID());
+                    }
+                }
+                break;
+
+              case Reload:
+                reload(partition);
+                break;
+            }
+        }
+      catch (ers::Issue & ex)
+        {
+          error(std::string(s_operation_names[op]) + " failed: " + ex.what());
+        }
+
+      stat.m_latency[op].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tp2).count() / 1000.);
     }
+}
 
-    f.close();
-    TLOG() << "finish with file " << fname.str();
-  }
-  catch (ers::Issue & ex) {
-    TLOG() << "ERROR [thread " << count << "]: caught " << ex;
-  }
+static double
+percentile(const std::vector<double>& sorted, unsigned int p)
+{
+  if (sorted.empty())
+    return 0;
+
+  return sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)];
 }
 
 int
 main(int argc, char *argv[])
 {
-  boost::program_options::options_description desc("Similar to dal_dump_apps, but run algorithms in multiple threads (to test config and DAL). Available options are:");
+  boost::program_options::options_description desc("Run mix of DAL algorithms in multiple threads, check results against serially computed reference and report throughput and latency. Available options are:");
 
   std::string db_name;
   std::string partition_name;
-  std::string object_id;
-  std::string app_name;
-  std::string segment_id;
-  int thread_num;
+  std::vector<unsigned int> threads;
+  unsigned int operations;
+  std::vector<unsigned int> weights(NumOfOperations);
 
   bool subst = false;
+  bool instrumentation = false;
+  bool concurrent_reload = false;
 
   try
     {
       desc.add_options()
         ("data,d", boost::program_options::value<std::string>(&db_name), "name of the database")
         ("partition-id,p", boost::program_options::value<std::string>(&partition_name)->required(), "name of the partition object")
-        ("application-id,a", boost::program_options::value<std::string>(&object_id), "identity of the application object (if not provided, dump all applications)")
-        ("application-name,n", boost::program_options::value<std::string>(&app_name), "name of the application object (if not provided, dump all applications)")
-        ("application-segment-id,g", boost::program_options::value<std::string>(&segment_id), "identity of the application's segment object (if defined, print apps of this segment)")
-        ("threads-number,t", boost::program_options::value<int>(&thread_num)->default_value(2), "number of threads")
+        ("threads-number,t", boost::program_options::value<std::vector<unsigned int>>(&threads)->multitoken(), "numbers of threads to test (default: 1 2 4 8)")
+        ("operations,n", boost::program_options::value<unsigned int>(&operations)->default_value(1000), "number of operations per thread")
+        ("get-segment", boost::program_options::value<unsigned int>(&weights[GetSegment])->default_value(1), "relative weight of get_segment() operation")
+        ("get-all-applications", boost::program_options::value<unsigned int>(&weights[GetAllApplications])->default_value(4), "relative weight of get_all_applications() operation")
+        ("disabled", boost::program_options::value<unsigned int>(&weights[Disabled])->default_value(8), "relative weight of disabled() operation")
+        ("get-info", boost::program_options::value<unsigned int>(&weights[GetInfo])->default_value(8), "relative weight of get_info() operation")
+        ("reload", boost::program_options::value<unsigned int>(&weights[Reload])->default_value(0), "relative weight of reload notification")
+        ("concurrent-reload,c", "run reload concurrently with disabled() and get_info() of applications defined by database (other operations still wait for reload)")
         ("substitute-variables,s","substitute database parameters")
+        ("instrumentation,I", "print counters, timers and heap allocations of DAL algorithms for each number of threads (if the library is built with instrumentation)")
         ("help,h", "Print help message");
 
       boost::program_options::variables_map vm;
@@ -206,6 +292,16 @@ main(int argc, char *argv[])
         {
           subst = true;
         }
+
+      if (vm.count("instrumentation"))
+        {
+          instrumentation = true;
+        }
+
+      if (vm.count("concurrent-reload"))
+        {
+          concurrent_reload = true;
+        }
     }
   catch (std::exception& ex)
     {
@@ -213,30 +309,155 @@ main(int argc, char *argv[])
       return EXIT_FAILURE;
     }
 
+  if (threads.empty())
+    threads = { 1, 2, 4, 8 };
 
-  std::cout << "run " << thread_num << " threads" << std::endl;
-
-  if(thread_num < 1)
+  if (std::find(threads.begin(), threads.end(), 0) != threads.end())
     {
       std::cerr << "ERROR: invalid number of threads" << std::endl;
-      return 1;
+      return EXIT_FAILURE;
+    }
+
+  if (std::all_of(weights.begin(), weights.end(), [](unsigned int w) { return w == 0; }))
+    {
+      std::cerr << "ERROR: all operations have zero weight" << std::endl;
+      return EXIT_FAILURE;
     }
 
+  uint64_t total_errors = 0;
+
   try
     {
       Configuration conf(db_name);
 
-      std::vector<std::thread> v;
-      v.reserve(thread_num);
+      const dunedaq::dal::Partition * partition = dunedaq::dal::get_partition(conf, partition_name);
+
+      if (!partition)
+        return EXIT_FAILURE;
 
-      for (int i = 1; i <= thread_num; ++i)
+      if (subst)
         {
-          v.push_back(std::thread(get_configuration, std::ref(conf), std::ref(partition_name), std::ref(object_id), std::ref(app_name), std::ref(segment_id), subst, i));
+          conf.register_converter(new dunedaq::dal::SubstituteVariables(*partition));
         }
 
-      for (int i = 0; i < thread_num; ++i)
+      // calculate reference serially
+
+      Reference ref;
+
+      ref.m_online_segment_id = partition->get_OnlineInfrastructure()->UID();
+      ref.m_applications = get_applications(*partition);
+
+      conf.get(ref.m_components);
+
+      for (const auto& x : ref.m_components)
+        ref.m_disabled.push_back(x->disabled(*partition));
+
+      for (const auto& x : partition->get_all_applications())
         {
-          v[i].join();
+          ref.m_info.emplace(x->UID(), get_info(*x));
+
+          if (x->get_base_app() == x)
+            ref.m_db_applications.push_back(x);
+        }
+
+      if (concurrent_reload && ref.m_db_applications.empty() && weights[GetInfo])
+        std::cerr << "WARNING: there are no applications defined by database, get_info() is not tested with concurrent reload" << std::endl;
+
+      std::cout << "partition " << partition_name << ": " << ref.m_applications.size() << " applications, " << ref.m_components.size() << " components\n\n";
+
+      std::cout << std::setw(8) << "threads" << std::setw(24) << "operation" << std::setw(10) << "count" << std::setw(12) << "ops/s" << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "wait us" << std::setw(8) << "errors" << std::endl;
+
+      double single_thread_throughput = 0;
+
+      for (const auto& num : threads)
+        {
+          std::vector<ThreadStatistics> stat(num);
+          std::shared_mutex reload_mutex;
+
+          // start from the same state for each number of threads
+
+          reload(*partition);
+
+          if (instrumentation)
+            dunedaq::dal::Instrumentation::reset();
+
+          auto tp = std::chrono::steady_clock::now();
+
+          std::vector<std::thread> v;
+          v.reserve(num);
+
+          for (unsigned int i = 0; i < num; ++i)
+            v.emplace_back([&, i]()
+              {
+                // attribute heap allocations of the thread to the instrumentation probes
+                std::unique_ptr<dunedaq::dal::Instrumentation::AllocationScope> allocation_scope(instrumentation ? new dunedaq::dal::Instrumentation::AllocationScope() : nullptr);
+                run_thread(*partition, ref, weights, operations, i + 1, reload_mutex, concurrent_reload, stat[i]);
+              });
+
+          for (auto& t : v)
+            t.join();
+
+          const double wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tp).count() / 1000000000.;
+
+          uint64_t errors = 0;
+          double lock_wait = 0;
+          double library_time = 0;
+
+          for (const auto& s : stat)
+            {
+              if (s.m_errors)
+                std::cerr << "ERROR: " << s.m_errors << " wrong results, first: " << s.m_first_error << std::endl;
+
+              errors += s.m_errors;
+
+              for (int op = 0; op < NumOfOperations; ++op)
+                {
+                  lock_wait += s.m_lock_wait[op];
+
+                  for (const auto& x : s.m_latency[op])
+                    library_time += x;
+                }
+            }
+
+          for (int op = 0; op < NumOfOperations; ++op)
+            {
+              std::vector<double> latency;
+              double op_lock_wait = 0;
+
+              for (const auto& s : stat)
+                {
+                  latency.insert(latency.end(), s.m_latency[op].begin(), s.m_latency[op].end());
+                  op_lock_wait += s.m_lock_wait[op];
+                }
+
+              if (latency.empty())
+                continue;
+
+              std::sort(latency.begin(), latency.end());
+
+              std::cout << std::setw(8) << num << std::setw(24) << s_operation_names[op] << std::setw(10) << latency.size() << std::fixed << std::setprecision(0)
+                        << std::setw(12) << latency.size() / wall_time << std::setprecision(1) << std::setw(12) << percentile(latency, 50) << std::setw(12) << percentile(latency, 99)
+                        << std::setw(12) << op_lock_wait / latency.size() << std::defaultfloat << std::setprecision(6) << std::setw(8) << "" << std::endl;
+            }
+
+          const double throughput = static_cast<double>(num) * operations / wall_time;
+
+          if (num == threads.front())
+            single_thread_throughput = throughput / num;
+
+          std::cout << std::setw(8) << num << std::setw(24) << "total" << std::setw(10) << static_cast<uint64_t>(num) * operations << std::fixed << std::setprecision(0) << std::setw(12) << throughput
+                    << std::setw(36) << "" << std::defaultfloat << std::setprecision(6) << std::setw(8) << errors << std::endl;
+
+          std::cout << "         wall time " << wall_time << " s, library time " << library_time / 1000000. << " s, test lock wait " << lock_wait / 1000000. << " s (" << std::fixed << std::setprecision(1) << (wall_time > 0 ? lock_wait / 10000. / (wall_time * num) : 0) << "% of thread time)"
+                    << ", scaling efficiency " << (single_thread_throughput > 0 ? throughput * 100. / (single_thread_throughput * num) : 0) << '%' << std::defaultfloat << std::setprecision(6) << "\n\n";
+
+          if (instrumentation)
+            {
+              dunedaq::dal::Instrumentation::print(std::cout);
+              std::cout << std::endl;
+            }
+
+          total_errors += errors;
         }
     }
   catch (ers::Issue & ex)
@@ -245,5 +466,5 @@ main(int argc, char *argv[])
       return (EXIT_FAILURE);
     }
 
-  return 0;
+  return (total_errors ? EXIT_FAILURE : EXIT_SUCCESS);
 }
@@ -9,6 +9,8 @@
 //	<Igor.Soloviev@cern.ch> - September 2005
 //
 
+#include <memory>
+
 #include <boost/program_options.hpp>
 
 #include "oksdbinterfaces/Configuration.hpp"
@@ -18,17 +20,48 @@
 #include "dal/OnlineSegment.hpp"
 #include "dal/Partition.hpp"
 
+#include "dal/launch-plan.hpp"
 #include "dal/util.hpp"
 
 
 using namespace dunedaq::oksdbinterfaces;
 
+static void
+print_environment(const std::map<std::string, std::string>& environment, const std::string& syntax)
+{
+  for (const auto & j : environment)
+    {
+      if (syntax == "sh")
+        std::cout << "export " << j.first << "=\"" << j.second << "\"\n";
+      else if (syntax == "csh")
+        std::cout << "setenv " << j.first << " \"" << j.second << "\"\n";
+    }
+}
+
+static bool
+print_environment(const dunedaq::dal::LaunchPlan& plan, const std::string& object_id, const std::string& syntax)
+{
+  for (uint32_t idx = 0; idx < plan.get_num_of_applications(); ++idx)
+    {
+      const dunedaq::dal::LaunchPlan::ApplicationRecord& i(plan.get_application(idx));
+
+      if (plan.get_string(i.m_id) == object_id)
+        {
+          print_environment(plan.get_environment(i), syntax);
+          return true;
+        }
+    }
+
+  return false;
+}
+
 int main(int argc, char *argv[])
 {
   std::string data;
   std::string partition_name;
   std::string object_id;
   std::string syntax;
+  std::string snapshot_dir;
 
   try
     {
@@ -39,6 +72,7 @@ int main(int argc, char *argv[])
           ("partition-name,p", boost::program_options::value<std::string>(&partition_name)->required(), "partition name")
           ("application-id,a", boost::program_options::value<std::string>(&object_id)->required(), "application name")
           ("shell-syntax,s", boost::program_options::value<std::string>(&syntax)->default_value("sh"), "shell syntax used to set environment variable value: \'sh\' (Bourne shell) or \'csh\' (C shell)")
+          ("snapshot-dir", boost::program_options::value<std::string>(&snapshot_dir), "directory of launch plan snapshots; if defined, read the plan for the partition, configuration version (TDAQ_DB_VERSION), database name and repository environment without loading the database, or create it")
           ("help,h", "Print help message");
 
       boost::program_options::variables_map vm;
@@ -64,6 +98,34 @@ int main(int argc, char *argv[])
       return EXIT_FAILURE;
     }
 
+  // use launch plan snapshot, if available
+
+  std::unique_ptr<dunedaq::dal::LaunchPlan> plan;
+  std::string plan_file, config_version, inputs;
+
+  if (!snapshot_dir.empty())
+    {
+      try
+        {
+          config_version = dunedaq::dal::get_config_version(partition_name);
+          inputs = dunedaq::dal::LaunchPlan::make_inputs(data);
+          plan_file = dunedaq::dal::LaunchPlan::get_file_name(snapshot_dir, partition_name, config_version, true, inputs);
+          plan = dunedaq::dal::LaunchPlan::open(plan_file, partition_name, config_version, true, inputs);
+        }
+      catch (ers::Issue & ex)
+        {
+          ers::warning(ex);
+        }
+
+      if (plan)
+        {
+          if (print_environment(*plan, object_id, syntax) == false)
+            std::cerr << "ERROR: cannot find application \'" << object_id << "\'" << std::endl;
+
+          return EXIT_SUCCESS;
+        }
+    }
+
   try
     {
       Configuration db(data);
@@ -73,6 +135,20 @@ int main(int argc, char *argv[])
         {
           db.register_converter(new dunedaq::dal::SubstituteVariables(*partition));
 
+          // create launch plan snapshot
+
+          if (!plan && !plan_file.empty())
+            {
+              try
+                {
+                  dunedaq::dal::LaunchPlan::write(plan_file, *partition, config_version, true, inputs);
+                }
+              catch (ers::Issue & ex)
+                {
+                  ers::warning(ex);
+                }
+            }
+
           std::set<std::string> segments;
 
           const dunedaq::dal::Segment * root_seg = partition->get_segment(partition->get_OnlineInfrastructure()->UID());
@@ -89,13 +165,7 @@ int main(int argc, char *argv[])
                   i->get_info(environment, file_names, startArgs, restartArgs);
 
                   // print environment
-                  for (const auto & j : environment)
-                    {
-                      if (syntax == "sh")
-                        std::cout << "export " << j.first << "=\"" << j.second << "\"\n";
-                      else if (syntax == "csh")
-                        std::cout << "setenv " << j.first << " \"" << j.second << "\"\n";
-                    }
+                  print_environment(environment, syntax);
 
                   return EXIT_SUCCESS;
                 }
@@ -26,9 +26,12 @@
 //                the localhost internally
 //	- Giovanna Lehmann Miotto (ATLAS C&C WG) - Jul 2009
 //		- add option to print host for a single application
+//
+//	- select hosts using masks of applications lifetime and restart
+//	  categories precomputed by the partition image
 
 #include <iostream>
-#include <set>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -38,9 +41,10 @@
 
 #include "dal/BaseApplication.hpp"
 #include "dal/Computer.hpp"
-#include "dal/CustomLifetimeApplicationBase.hpp"
 #include "dal/Partition.hpp"
 
+#include "dal/launch-plan.hpp"
+#include "dal/partition-image.hpp"
 #include "dal/util.hpp"
 
 using namespace dunedaq::oksdbinterfaces;
@@ -62,6 +66,22 @@ printHost(const dunedaq::dal::Computer * host, bool print_rl_cmd, bool print_tag
   std::cout << std::endl;
 }
 
+static void
+printHost(const dunedaq::dal::LaunchPlan& plan, const dunedaq::dal::LaunchPlan::HostRecord& host, bool print_rl_cmd, bool print_tag)
+{
+  std::cout << plan.get_string(host.m_id);
+
+  if(print_rl_cmd) {
+    std::cout << ' ' << plan.get_string(host.m_rlogin);
+  }
+
+  if(print_tag) {
+    std::cout << ' ' << plan.get_string(host.m_hw_tag);
+  }
+
+  std::cout << std::endl;
+}
+
 
 int
 main(int argc, char **argv)
@@ -69,6 +89,7 @@ main(int argc, char **argv)
   std::string data;
   std::string partition;
   std::string application;
+  std::string snapshot_dir;
 
   bool ignore_non_restartable = false;
   bool ignore_started_at_boot = false;
@@ -110,6 +131,7 @@ main(int argc, char **argv)
         ("print-remote-login-command,L","prints host remote login command")
         ("print-binary-tag,T","prints host hardware tag")
         ("all,A","prints any defined host including non-used by the partition")
+        ("snapshot-dir", boost::program_options::value<std::string>(&snapshot_dir), "directory of launch plan snapshots; if defined, read the plan for the partition, configuration version (TDAQ_DB_VERSION), database name and repository environment without loading the database, or create it")
         ("help,h", "Print help message");
 
       boost::program_options::variables_map vm;
@@ -165,6 +187,84 @@ main(int argc, char **argv)
       return EXIT_FAILURE;
     }
 
+  // build mask of categories of applications to be used
+
+  typedef dunedaq::dal::PartitionImage PI;
+
+  PI::CategoryMask ignored = 0;
+
+  // ignore non-restartable applications if required
+  if (ignore_non_restartable)
+    ignored |= PI::non_restartable_categories;
+
+  // ignore started or stopped at certain moment if required
+  if (ignore_started_at_boot || ignore_stopped_at_shut)
+    ignored |= PI::get_lifetime_categories(PI::BootShutdown);
+
+  if (ignore_started_at_sor || ignore_stopped_at_eor)
+    ignored |= PI::get_lifetime_categories(PI::SorEor);
+
+  if (ignore_started_at_eor || ignore_stopped_at_sor)
+    ignored |= PI::get_lifetime_categories(PI::EorSor);
+
+  if (ignore_started_by_user || ignore_stopped_by_user)
+    ignored |= PI::get_lifetime_categories(PI::UserDefinedShutdown);
+
+  const PI::CategoryMask categories = PI::all_categories & ~ignored;
+
+  // use launch plan snapshot, if available
+
+  std::unique_ptr<dunedaq::dal::LaunchPlan> plan;
+  std::string plan_file, config_version, inputs;
+
+  if (!snapshot_dir.empty())
+    {
+      try
+        {
+          config_version = dunedaq::dal::get_config_version(partition);
+          inputs = dunedaq::dal::LaunchPlan::make_inputs(data);
+          plan_file = dunedaq::dal::LaunchPlan::get_file_name(snapshot_dir, partition, config_version, true, inputs);
+          plan = dunedaq::dal::LaunchPlan::open(plan_file, partition, config_version, true, inputs);
+        }
+      catch (ers::Issue & ex)
+        {
+          ers::warning(ex);
+        }
+
+      if (plan)
+        {
+          if (print_all)
+            {
+              for (uint32_t i = 0; i < plan->get_num_of_hosts(); ++i)
+                printHost(*plan, plan->get_host(i), print_rl_cmd, print_tag);
+            }
+          else
+            {
+              std::vector<bool> hosts(plan->get_num_of_hosts(), false);
+
+              for (uint32_t idx = 0; idx < plan->get_num_of_applications(); ++idx)
+                {
+                  const dunedaq::dal::LaunchPlan::ApplicationRecord& i(plan->get_application(idx));
+
+                  // search only for one specific application
+                  if (!application.empty() && (plan->get_string(i.m_id) != application))
+                    continue;
+
+                  if ((categories & (1 << PI::get_category(PI::get_lifetime(plan->get_string(i.m_lifetime)), i.m_restartable))) == 0)
+                    continue;
+
+                  if (i.m_host != dunedaq::dal::LaunchPlan::npos && hosts[i.m_host] == false)
+                    {
+                      hosts[i.m_host] = true;
+                      printHost(*plan, plan->get_host(i.m_host), print_rl_cmd, print_tag);
+                    }
+                }
+            }
+
+          return EXIT_SUCCESS;
+        }
+    }
+
   try
     {
       Configuration conf(data);
@@ -176,6 +276,19 @@ main(int argc, char **argv)
 
       conf.register_converter(new dunedaq::dal::SubstituteVariables(*p));
 
+      // create launch plan snapshot
+      if (!plan_file.empty())
+        {
+          try
+            {
+              dunedaq::dal::LaunchPlan::write(plan_file, *p, config_version, true, inputs);
+            }
+          catch (ers::Issue & ex)
+            {
+              ers::warning(ex);
+            }
+        }
+
       // print all hosts defined by the configuration
       if (print_all)
         {
@@ -187,52 +300,40 @@ main(int argc, char **argv)
         }
       else
         {
+          const std::shared_ptr<const dunedaq::dal::PartitionImage> image_ptr(p->get_image()); // keeps the image arrays alive on reload
+          const dunedaq::dal::PartitionImage& image(*image_ptr);
 
-          // remember visited hosts
-          std::string appName(application);
-          std::set<const dunedaq::dal::Computer *, std::less<const dunedaq::dal::Computer *> > hosts;
-
-          // iterate over the list of applications to retrieve host names and add them to "hosts"
-          for(auto & i : p->get_all_applications())
+          if (application.empty())
             {
-              const dunedaq::dal::BaseApplication * a = i->get_base_app();
+              // the masks of categories of applications per host are precomputed by the image
+
+              std::vector<const dunedaq::dal::Computer *> hosts;
+              image.select_hosts(hosts, categories);
 
- 	      // search only for one specific application
-	      if (!appName.empty() && (i->UID() != appName))
-	        continue;
+              for (const auto& i : hosts)
+                printHost(i, print_rl_cmd, print_tag);
+            }
+          else
+            {
+              // search only for one specific application
 
-              // ignore non-restartable applications if required
-              if(
-                ignore_non_restartable && a->get_IfExitsUnexpectedly() != dunedaq::dal::BaseApplication::IfExitsUnexpectedly::Restart &&
-                a->get_IfFailsToStart() != dunedaq::dal::BaseApplication::IfFailsToStart::Restart
-              ) continue;
+              std::vector<bool> hosts(image.get_hosts().size(), false);
 
-              if(const dunedaq::dal::CustomLifetimeApplicationBase * ca = a->cast<dunedaq::dal::CustomLifetimeApplicationBase>())
+              for (uint32_t idx = 0; idx < image.get_num_of_applications(); ++idx)
                 {
-                  // ignore started at certain moment if required
-                  if(
-                    (ignore_started_at_boot && ca->get_Lifetime() == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::Boot_Shutdown)       ||
-                    (ignore_started_at_sor  && ca->get_Lifetime() == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::SOR_EOR)             ||
-                    (ignore_started_at_eor  && ca->get_Lifetime() == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::EOR_SOR)             ||
-                    (ignore_started_by_user && ca->get_Lifetime() == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::UserDefined_Shutdown)
-                  ) continue;
-
-
-                  // ignore stopped at certain moment if required
-                  if(
-                    (ignore_stopped_at_sor  && ca->get_Lifetime() == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::EOR_SOR)             ||
-                    (ignore_stopped_at_eor  && ca->get_Lifetime() == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::SOR_EOR)             ||
-                    (ignore_stopped_at_shut && ca->get_Lifetime() == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::Boot_Shutdown)       ||
-                    (ignore_stopped_by_user && ca->get_Lifetime() == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::UserDefined_Shutdown)
-                  ) continue;
-                }
+                  if (image.get_applications()[idx]->UID() != application)
+                    continue;
 
-              const dunedaq::dal::Computer * host = i->get_host();
+                  if ((categories & (1 << image.get_application_categories()[idx])) == 0)
+                    continue;
 
-              if (hosts.find(host) == hosts.end())
-                {
-                  hosts.insert(host);
-                  printHost(host, print_rl_cmd, print_tag);
+                  const uint32_t host_idx = image.get_application_hosts()[idx];
+
+                  if (hosts[host_idx] == false)
+                    {
+                      hosts[host_idx] = true;
+                      printHost(image.get_hosts()[host_idx], print_rl_cmd, print_tag);
+                    }
                 }
             }
         }
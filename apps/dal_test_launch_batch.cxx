@@ -0,0 +1,356 @@
+//
+//  FILE: src/dal_test_launch_batch.cpp
+//
+//  Test encoding and decoding of launch batches:
+//    - the applications decoded from a batch are equal to the encoded ones
+//    - the truncated batches are rejected
+//    - the corrupted batches are rejected or all their views stay inside the buffer
+//    - the checked accessors reject out of range indexes
+//
+//  The applications are generated; if the database and the partition
+//  are defined, the applications of the partition are added too.
+//
+//  For command line arguments see function usage() or run the program
+//  with --help.
+//
+
+#include <stdlib.h>
+
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "oksdbinterfaces/Configuration.hpp"
+
+#include "dal/BaseApplication.hpp"
+#include "dal/Computer.hpp"
+#include "dal/OnlineSegment.hpp"
+#include "dal/Partition.hpp"
+#include "dal/Segment.hpp"
+#include "dal/Tag.hpp"
+
+#include "dal/launch-batch.hpp"
+#include "dal/util.hpp"
+
+
+using namespace dunedaq::oksdbinterfaces;
+
+
+namespace {
+
+  struct TestApplication
+  {
+    std::string m_name;
+    std::string m_host;
+    std::vector<std::string> m_backup_hosts;
+    std::string m_tag;
+    std::vector<std::string> m_program_names;
+    std::map<std::string, std::string> m_environment;
+    std::string m_start_args;
+    std::string m_restart_args;
+  };
+
+  unsigned int s_failures = 0;
+
+  void
+  check(bool value, const std::string& text)
+  {
+    if (!value)
+      {
+        std::cerr << "FAILED: " << text << std::endl;
+        s_failures++;
+      }
+  }
+
+  std::vector<TestApplication>
+  generate(unsigned int num)
+  {
+    std::vector<TestApplication> apps(num);
+
+    for (unsigned int i = 0; i < num; ++i)
+      {
+        TestApplication& a(apps[i]);
+
+        a.m_name = "app-" + std::to_string(i);
+        a.m_host = "host-" + std::to_string(i % 7);
+        a.m_tag = (i % 2 ? "x86_64-el9-gcc12-opt" : "x86_64-el9-gcc12-dbg");
+
+        for (unsigned int j = 0; j < i % 3; ++j)
+          a.m_backup_hosts.push_back("host-" + std::to_string((i + j + 1) % 7));
+
+        for (unsigned int j = 0; j < i % 4; ++j)
+          a.m_program_names.push_back("/sw/repo-" + std::to_string(j) + "/bin/program-" + std::to_string(i % 5));
+
+        a.m_environment["PATH"] = "/sw/repo-0/bin:/sw/repo-1/bin";
+        a.m_environment["TDAQ_APPLICATION_NAME"] = a.m_name;
+
+        if (i % 5 == 0)
+          a.m_environment["EMPTY"] = "";
+
+        a.m_start_args = (i % 6 ? "-n " + a.m_name : "");
+        a.m_restart_args = a.m_start_args + (i % 2 ? " -r" : "");
+      }
+
+    return apps;
+  }
+
+  void
+  compare(const dunedaq::dal::LaunchBatchReader& batch, const std::vector<TestApplication>& apps)
+  {
+    check(batch.get_num_of_applications() == apps.size(), "number of applications");
+
+    for (uint32_t i = 0; i < batch.get_num_of_applications() && i < apps.size(); ++i)
+      {
+        const dunedaq::dal::LaunchBatchReader::Application a(batch.get_application(i));
+        const TestApplication& t(apps[i]);
+        const std::string text(" of application " + t.m_name);
+
+        check(a.get_name() == t.m_name, "name" + text);
+        check(a.get_host() == t.m_host, "host" + text);
+        check(a.get_tag() == t.m_tag, "tag" + text);
+        check(a.get_start_args() == t.m_start_args, "start arguments" + text);
+        check(a.get_restart_args() == t.m_restart_args, "restart arguments" + text);
+
+        check(a.get_num_of_backup_hosts() == t.m_backup_hosts.size(), "number of backup hosts" + text);
+        for (uint32_t j = 0; j < a.get_num_of_backup_hosts() && j < t.m_backup_hosts.size(); ++j)
+          check(a.get_backup_host(j) == t.m_backup_hosts[j], "backup host" + text);
+
+        check(a.get_num_of_program_names() == t.m_program_names.size(), "number of program names" + text);
+        for (uint32_t j = 0; j < a.get_num_of_program_names() && j < t.m_program_names.size(); ++j)
+          check(a.get_program_name(j) == t.m_program_names[j], "program name" + text);
+
+        check(a.get_num_of_environment() == t.m_environment.size(), "number of environment variables" + text);
+        auto it = t.m_environment.begin();
+        for (uint32_t j = 0; j < a.get_num_of_environment() && it != t.m_environment.end(); ++j, ++it)
+          check(a.get_environment_name(j) == it->first && a.get_environment_value(j) == it->second, "environment variable" + text);
+      }
+  }
+
+    // read all fields of accepted batch; return false, if any view is outside the buffer
+
+  bool
+  read_all(const dunedaq::dal::LaunchBatchReader& batch, const char * data, size_t size)
+  {
+    bool result = true;
+
+    auto inside = [&](std::string_view v)
+      {
+        if (v.size() && (v.data() < data || v.data() + v.size() > data + size))
+          result = false;
+      };
+
+    for (uint32_t i = 0; i < batch.get_num_of_applications(); ++i)
+      {
+        const dunedaq::dal::LaunchBatchReader::Application a(batch.get_application(i));
+
+        inside(a.get_name());
+        inside(a.get_host());
+        inside(a.get_tag());
+        inside(a.get_start_args());
+        inside(a.get_restart_args());
+
+        for (uint32_t j = 0; j < a.get_num_of_backup_hosts(); ++j)
+          inside(a.get_backup_host(j));
+
+        for (uint32_t j = 0; j < a.get_num_of_program_names(); ++j)
+          inside(a.get_program_name(j));
+
+        for (uint32_t j = 0; j < a.get_num_of_environment(); ++j)
+          {
+            inside(a.get_environment_name(j));
+            inside(a.get_environment_value(j));
+          }
+      }
+
+    return result;
+  }
+
+  template<class F>
+    bool
+    throws_out_of_range(F f)
+    {
+      try
+        {
+          f();
+        }
+      catch (std::out_of_range&)
+        {
+          return true;
+        }
+
+      return false;
+    }
+
+}
+
+
+int
+main(int argc, char *argv[])
+{
+  boost::program_options::options_description desc("Test encoding and decoding of launch batches by dunedaq::dal::LaunchBatchWriter and dunedaq::dal::LaunchBatchReader.");
+
+  std::string db_name;
+  std::string partition_name;
+  unsigned int num_of_apps = 50;
+
+  try
+    {
+      desc.add_options()
+        ("data,d", boost::program_options::value<std::string>(&db_name), "name of the database (if defined, add applications of the partition)")
+        ("partition-id,p", boost::program_options::value<std::string>(&partition_name), "name of the partition object")
+        ("number-of-applications,n", boost::program_options::value<unsigned int>(&num_of_apps)->default_value(num_of_apps), "number of generated applications")
+        ("help,h", "Print help message");
+
+      boost::program_options::variables_map vm;
+      boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help"))
+        {
+          std::cout << desc << std::endl;
+          return EXIT_SUCCESS;
+        }
+
+      boost::program_options::notify(vm);
+    }
+  catch (std::exception& ex)
+    {
+      std::cerr << "Command line parsing errors occurred:\n" << ex.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::vector<TestApplication> apps(generate(num_of_apps));
+
+  // add applications of the partition using get_info() algorithm
+
+  if (!db_name.empty() && !partition_name.empty())
+    {
+      try
+        {
+          Configuration conf(db_name);
+
+          const dunedaq::dal::Partition * partition = dunedaq::dal::get_partition(conf, partition_name);
+
+          if (!partition)
+            return EXIT_FAILURE;
+
+          conf.register_converter(new dunedaq::dal::SubstituteVariables(*partition));
+
+          for (const auto& i : partition->get_segment(partition->get_OnlineInfrastructure()->UID())->get_all_applications())
+            {
+              TestApplication a;
+
+              a.m_name = i->UID();
+              a.m_host = i->get_host()->UID();
+
+              for (const auto& h : i->get_backup_hosts())
+                a.m_backup_hosts.push_back(h->UID());
+
+              a.m_tag = i->get_info(a.m_environment, a.m_program_names, a.m_start_args, a.m_restart_args)->UID();
+
+              apps.push_back(std::move(a));
+            }
+        }
+      catch (ers::Issue & ex)
+        {
+          std::cerr << "Caught " << ex << std::endl;
+          return EXIT_FAILURE;
+        }
+    }
+
+  dunedaq::dal::LaunchBatchWriter writer;
+
+  for (const auto& a : apps)
+    writer.add(a.m_name, a.m_host, a.m_backup_hosts, a.m_tag, a.m_program_names, a.m_environment, a.m_start_args, a.m_restart_args);
+
+  const std::string batch(writer.encode());
+
+  std::cout << "encoded " << apps.size() << " applications into " << batch.size() << " bytes" << std::endl;
+
+  // round trip; the reader does not require alignment
+
+  try
+    {
+      const std::string misaligned(' ' + batch);
+
+      compare(dunedaq::dal::LaunchBatchReader(batch.data(), batch.size()), apps);
+      compare(dunedaq::dal::LaunchBatchReader(misaligned.data() + 1, batch.size()), apps);
+
+      const dunedaq::dal::LaunchBatchReader reader(batch.data(), batch.size());
+
+      check(throws_out_of_range([&]() { reader.at_application(reader.get_num_of_applications()); }), "application index is not checked");
+
+      if (reader.get_num_of_applications())
+        {
+          const dunedaq::dal::LaunchBatchReader::Application a(reader.at_application(0));
+
+          check(throws_out_of_range([&]() { a.at_backup_host(a.get_num_of_backup_hosts()); }), "backup host index is not checked");
+          check(throws_out_of_range([&]() { a.at_program_name(a.get_num_of_program_names()); }), "program name index is not checked");
+          check(throws_out_of_range([&]() { a.at_environment(a.get_num_of_environment()); }), "environment variable index is not checked");
+        }
+    }
+  catch (std::exception& ex)
+    {
+      check(false, std::string("valid batch is rejected: ") + ex.what());
+    }
+
+  // truncated batches
+
+  unsigned int num_of_rejected = 0;
+
+  for (size_t len = 0; len < batch.size(); ++len)
+    {
+      try
+        {
+          dunedaq::dal::LaunchBatchReader reader(batch.data(), len);
+          check(false, "batch truncated to " + std::to_string(len) + " bytes is accepted");
+        }
+      catch (std::runtime_error&)
+        {
+          num_of_rejected++;
+        }
+    }
+
+  std::cout << "rejected " << num_of_rejected << " truncated batches" << std::endl;
+
+  // corrupted batches: change each byte of header, application records and references
+
+  const size_t strings_offset = batch.size() - dunedaq::dal::LaunchBatchReader::read32(reinterpret_cast<const unsigned char *>(batch.data()) + dunedaq::dal::LaunchBatchReader::h_strings_size * 4);
+
+  unsigned int num_of_accepted = 0;
+  num_of_rejected = 0;
+
+  for (size_t pos = 0; pos < strings_offset; ++pos)
+    for (unsigned char mask : { 0x01, 0x80, 0xff })
+      {
+        std::string bad(batch);
+        bad[pos] ^= mask;
+
+        try
+          {
+            dunedaq::dal::LaunchBatchReader reader(bad.data(), bad.size());
+            check(read_all(reader, bad.data(), bad.size()), "batch with corrupted byte " + std::to_string(pos) + " has view outside buffer");
+            num_of_accepted++;
+          }
+        catch (std::runtime_error&)
+          {
+            num_of_rejected++;
+          }
+      }
+
+  std::cout << "rejected " << num_of_rejected << " and safely read " << num_of_accepted << " corrupted batches" << std::endl;
+
+  if (s_failures)
+    {
+      std::cerr << s_failures << " checks failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::cout << "all checks passed" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -1,6 +1,7 @@
 #ifndef _dal_app_config_H_
 #define _dal_app_config_H_
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -39,6 +40,9 @@ namespace dunedaq::dal {
      *  An object of AppConfig class may only be created by the SegConfig::get_all_applications() and
      *  the dunedaq::dal::Partition::get_all_applications() algorithms. A user should not create an object of AppConfig class
      *  (constructor remains public by efficiency reasons).
+     *
+     *  The objects created by the algorithms are allocated from the arena of the segments tree generation
+     *  (see dunedaq::dal::ApplicationConfig) and are released together with it.
      **/
 
     class AppConfig
@@ -118,21 +122,12 @@ namespace dunedaq::dal {
       const Computer * m_host;
       const Segment * m_segment;
       bool m_is_templated;
-      std::vector<const dunedaq::dal::Computer *> m_template_backup_hosts;
-
-      void
-      clear()
-      {
-        m_base_app = nullptr;
-        m_host = nullptr;
-        m_segment = nullptr;
-        m_is_templated = false;
-        m_template_backup_hosts.clear();
-      }
+      std::pmr::vector<const dunedaq::dal::Computer *> m_template_backup_hosts;
 
-      AppConfig()
+      AppConfig(std::pmr::memory_resource * mr) :
+          m_base_app(nullptr), m_host(nullptr), m_segment(nullptr), m_is_templated(false), m_template_backup_hosts(mr)
       {
-        clear();
+        ;
       }
 
     };
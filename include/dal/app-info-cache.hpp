@@ -0,0 +1,182 @@
+#ifndef _dal_app_info_cache_H_
+#define _dal_app_info_cache_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "oksdbinterfaces/Configuration.hpp"
+#include "oksdbinterfaces/ConfigAction.hpp"
+#include "oksdbinterfaces/DalObject.hpp"
+
+namespace dunedaq::dal {
+
+      // forward declarations
+
+    class BaseApplication;
+    class Tag;
+
+    /**
+     * \brief The class implements persistent content-addressed cache of dunedaq::dal::BaseApplication::get_info() results
+     *
+     *  The cache stores environment, possible program names, start and restart arguments and the tag
+     *  computed for an application in a local directory. The file name of an entry is the hash of all
+     *  inputs of the algorithm:
+     *  - the contents of every database object the result depends on: the base application, its program,
+     *    used software packages, variables, tags, host, partition and segments on the path from the
+     *    root segment to the application (i.e. the closure of their relationships, except relationships
+     *    describing the control tree);
+     *  - the control tree facts used by the algorithm: the application's identity and host, the segments
+     *    path and the identities, hosts and backup hosts of infrastructure applications of these segments;
+     *  - the process environment read by the algorithm (TDAQ_DB_REPOSITORY, TDAQ_DB_USER_REPOSITORY,
+     *    OKS_REPOSITORY_MAPPING_DIR and variables referenced as $(NAME) by partition's database parameters);
+     *  - the user context (e.g. registered attribute converters).
+     *
+     *  Any change of a dependency changes the key, so stale entries are never used; they are simply not
+     *  addressed anymore and can be removed by an external cleaner. The results of Java scripts are not
+     *  cached, since their CLASSPATH depends on presence of jar files in the file system. For the same reason
+     *  nothing is cached, when any of dunedaq::dal::LaunchOptions is enabled.
+     *
+     *  The hashes of database objects are memorized and reset on any configuration change notification.
+     *  The object is thread-safe.
+     *
+     *  \par Example
+     *
+     *  <pre><i>
+     *
+     *  dunedaq::dal::AppInfoCache cache(db, "/tmp/dal-info-cache", "subst");
+     *
+     *  for (const auto& a : partition->get_all_applications()) {
+     *    std::map<std::string, std::string> env;
+     *    std::vector<std::string> names;
+     *    std::string start_args, restart_args;
+     *    cache.get_info(*a, env, names, start_args, restart_args);
+     *    ...
+     *  }
+     *
+     *  </i></pre>
+     **/
+
+    class AppInfoCache : public dunedaq::oksdbinterfaces::ConfigAction
+    {
+
+    public:
+
+      /**
+       *  \brief Build cache object.
+       *
+       *  \param db       the configuration database
+       *  \param dir      the cache directory (created if does not exist)
+       *  \param context  the user context, that has to distinguish configurations with different attribute converters
+       *
+       *  \throw dunedaq::dal::BadAppInfoCache if the directory cannot be created
+       */
+
+      AppInfoCache(dunedaq::oksdbinterfaces::Configuration& db, const std::string& dir, const std::string& context = "");
+
+      virtual
+      ~AppInfoCache();
+
+      /**
+       *  \brief Get application info from cache or compute it.
+       *
+       *  The parameters and the exceptions are the same as for dunedaq::dal::BaseApplication::get_info().
+       *  The problems with cache files are reported as warnings and do not prevent computation of the result.
+       *
+       *  \return tag for this application
+       */
+
+      const dunedaq::dal::Tag *
+      get_info(const dunedaq::dal::BaseApplication& app, std::map<std::string, std::string>& environment, std::vector<std::string>& program_names, std::string& startArgs, std::string& restartArgs);
+
+      /// Get the key of application's entry as hexadecimal string.
+
+      std::string
+      get_key(const dunedaq::dal::BaseApplication& app);
+
+      /// Get number of results read from cache.
+
+      uint64_t
+      get_hits() const
+      {
+        return m_hits;
+      }
+
+      /// Get number of computed results.
+
+      uint64_t
+      get_misses() const
+      {
+        return m_misses;
+      }
+
+      void
+      notify(std::vector<dunedaq::oksdbinterfaces::ConfigurationChange *>& /*changes*/) noexcept
+      {
+        __clear();
+      }
+
+      void
+      load() noexcept
+      {
+        __clear();
+      }
+
+      void
+      unload() noexcept
+      {
+        __clear();
+      }
+
+      void
+      update(const dunedaq::oksdbinterfaces::ConfigObject& /*obj*/, const std::string& /*name*/) noexcept
+      {
+        __clear();
+      }
+
+
+    private:
+
+      void
+      __clear() noexcept
+      {
+        std::lock_guard<std::mutex> scoped_lock(m_mutex);
+        m_objects.clear();
+      }
+
+      dunedaq::oksdbinterfaces::Configuration& m_db;
+      const std::string m_dir;
+      const std::string m_context;
+
+      std::atomic<uint64_t> m_hits;
+      std::atomic<uint64_t> m_misses;
+
+      // memorized hash of database object contents and names of process environment variables it references as $(NAME)
+      struct ObjectInfo
+      {
+        uint64_t m_hash;
+        std::set<std::string> m_env_refs;
+      };
+
+      std::mutex m_mutex;
+      std::unordered_map<const dunedaq::oksdbinterfaces::DalObject *, ObjectInfo> m_objects;
+
+      bool
+      read(const std::string& key, std::map<std::string, std::string>& environment, std::vector<std::string>& program_names, std::string& startArgs, std::string& restartArgs, std::string& tag);
+
+      void
+      write(const std::string& key, const std::map<std::string, std::string>& environment, const std::vector<std::string>& program_names, const std::string& startArgs, const std::string& restartArgs, const std::string& tag);
+
+      std::string
+      get_file_name(const std::string& key, bool make_dir) const;
+
+    };
+} // namespace dunedaq::dal
+
+#endif
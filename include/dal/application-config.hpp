@@ -1,37 +1,194 @@
 #ifndef _dal_application_config_H_
 #define _dal_application_config_H_
 
+#include <stdint.h>
+
 #include <atomic>
+#include <map>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "oksdbinterfaces/ConfigAction.hpp"
 
+#include "dal/class-mask.hpp"
+#include "dal/partition-image.hpp"
+#include "dal/variables-cache.hpp"
+
 namespace dunedaq {
   namespace oksdbinterfaces {
     class Configuration;
+    class DalObject;
   }
 }
 
 namespace dunedaq::dal {
 
+    class AppConfig;
+    class BaseApplication;
     class Segment;
+    class SegConfig;
     class Partition;
+    class SW_Repository;
+    class Tag;
 
     class ApplicationConfig : public dunedaq::oksdbinterfaces::ConfigAction
     {
       friend class Partition;
+      friend class AlgorithmUtils;
 
     private:
 
+      /**
+       *  The storage of single generation of the segments tree.
+       *
+       *  The SegConfig and AppConfig objects built by the Partition::get_segment() algorithm are allocated
+       *  from the monotonic arena of the generation. Only these objects (and the backup hosts of templated
+       *  applications) use the arena: the pointer vectors of SegConfig returned by the Segment getters as
+       *  std::vector references use the heap, so the SegConfig objects are destroyed with the generation.
+       *  The generation remembers segment and application objects pointing into the arena;
+       *  on release their pointers are reset (unless they were set by another partition sharing the object)
+       *  and the arena memory is freed at once.
+       *
+       *  The generation is reference counted: the readers (e.g. the holders of Partition::get_image() result)
+       *  keep it alive, when the configuration is reloaded or changed by another thread. The pointers of generated
+       *  objects are reset by the ApplicationConfig when the generation is replaced, not when it is destroyed,
+       *  so a generation outliving its replacement never touches objects of the newer one.
+       *  The compiled image of the tree is built at the end of the generation in the same arena.
+       *
+       *  The generation also keeps immutable layers of process environment shared by applications
+       *  (see BaseApplication::get_info()): the front partition environment and the environment
+       *  defined by segments on the path from the partition to application's segment per tag.
+       *  The layers are reference counted and stay valid for a caller when the generation is released.
+       */
+
+      struct Generation
+      {
+        Generation() :
+          m_arena(initial_arena_size),
+          m_image(&m_arena)
+        {
+          m_segments.reserve(64);
+          m_applications.reserve(256);
+          m_app_configs.reserve(256);
+        }
+
+        /// destroy SegConfig objects allocated in the arena
+        ~Generation();
+
+        /// initial size of arena buffer (the next buffers grow geometrically)
+        enum {
+          initial_arena_size = 64 * 1024
+        };
+
+        /// maximum number of front environment layers kept per generation (the least recently used is evicted)
+        enum {
+          max_front_environments = 8
+        };
+
+        /// names and values of environment variables; the first definition of variable has priority
+        typedef std::vector<std::pair<std::string, std::string>> EnvironmentLayer;
+
+        /// the key is the application's segment of the tree (defining whole path) and the tag
+        typedef std::map<std::pair<const Segment *, const Tag *>, std::shared_ptr<const EnvironmentLayer>> SegmentsEnvironment;
+
+        std::pmr::monotonic_buffer_resource m_arena;
+        std::vector<Segment *> m_segments;
+        std::vector<BaseApplication *> m_applications;
+        std::vector<AppConfig *> m_app_configs;      // the AppConfig of m_applications[i] is m_app_configs[i]
+        std::vector<SegConfig *> m_seg_configs;      // the SegConfig of m_segments[i] is m_seg_configs[i]
+        PartitionImage m_image;
+
+        std::mutex m_environment_mutex;
+        /// the front environment depends on the process environment and is kept per dunedaq::dal::EnvironmentSource identity;
+        /// the most recently used layer is the last one, short-lived sources (e.g. of Scope objects) are evicted
+        std::vector<std::pair<uint64_t, std::shared_ptr<const EnvironmentLayer>>> m_front_environment;
+        SegmentsEnvironment m_segments_environment;
+
+        /// timeouts of all segments are computed once per generation (see Segment::get_timeouts())
+        std::once_flag m_timeouts_flag;
+      };
+
+      /// result of single-pass validation of objects graph (see find_dependency_cycle())
+      enum GraphState : int8_t {
+        GraphNotValidated,
+        GraphAcyclic,
+        GraphHasCycle
+      };
+
       dunedaq::oksdbinterfaces::Configuration& m_db;
       mutable std::atomic<const dunedaq::dal::Segment*> m_root_segment;
       mutable std::mutex m_root_segment_mutex;
+      std::shared_ptr<Generation> m_generation; // modified under m_root_segment_mutex
+      mutable std::atomic<GraphState> m_graph_state;
+      mutable std::mutex m_graph_mutex;
+      mutable std::unordered_set<const dunedaq::oksdbinterfaces::DalObject *> m_graph_objects; // objects checked by last validation; modified under m_graph_mutex
+      mutable VariablesCache m_variables;
+      mutable std::mutex m_repositories_mutex;
+      mutable std::unique_ptr<const std::set<const SW_Repository *>> m_used_repositories; // result of get_used_repositories()
+      mutable std::unordered_map<std::string, std::pair<uint64_t, std::string>> m_class_paths; // resolved JARs and FileSystemProbe version per repositories and repository root
+
+      void
+      __clear_repositories() noexcept
+      {
+        std::lock_guard<std::mutex> scoped_lock(m_repositories_mutex);
+        m_used_repositories.reset();
+        m_class_paths.clear();
+      }
+
+      // reset pointers of generated objects and release the generation; called under m_root_segment_mutex
+      void
+      __release_generation() noexcept;
+
+      // return current generation (if any) keeping it alive
+      std::shared_ptr<Generation>
+      __get_generation() const noexcept
+      {
+        std::lock_guard<std::mutex> scoped_lock(m_root_segment_mutex);
+        return m_generation;
+      }
+
+      // reset results depending on disabled components (see Partition::set_disabled()); the values of variables do not depend on them and are kept
+      void
+      __reset_tree() noexcept
+      {
+        std::lock_guard<std::mutex> scoped_lock(m_root_segment_mutex);
+        m_root_segment.store(nullptr);
+        __release_generation();
+        m_graph_state.store(GraphNotValidated);
+        __clear_repositories();
+      }
 
       void
       __clear() noexcept
+      {
+        __reset_tree();
+        m_variables.clear();
+      }
+
+      // release the generation without touching generated objects, that are destroyed together with the configuration cache
+      void
+      __drop() noexcept
       {
         std::lock_guard<std::mutex> scoped_lock(m_root_segment_mutex);
         m_root_segment.store(nullptr);
+        m_graph_state.store(GraphNotValidated);
+        m_variables.clear();
+        __clear_repositories();
+
+        if (m_generation)
+          {
+            m_generation->m_segments.clear();
+            m_generation->m_applications.clear();
+            m_generation->m_app_configs.clear();
+            m_generation.reset();
+          }
       }
 
     public:
@@ -47,16 +204,20 @@ namespace dunedaq::dal {
         __clear();
       }
 
+      // the database schema may change, so reset the masks of classes too
+
       void
       load() noexcept
       {
         __clear();
+        ClassMask::reset();
       }
 
       void
       unload() noexcept
       {
-        __clear();
+        __drop();
+        ClassMask::reset();
       }
 
       void
@@ -0,0 +1,190 @@
+#ifndef _dal_class_mask_H_
+#define _dal_class_mask_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include "oksdbinterfaces/DalObject.hpp"
+
+namespace dunedaq::dal {
+
+    class Application;
+    class BaseApplication;
+    class Component;
+    class Computer;
+    class ComputerSet;
+    class InfrastructureApplication;
+    class InfrastructureBase;
+    class Parameter;
+    class Resource;
+    class ResourceBase;
+    class ResourceSet;
+    class ResourceSetAND;
+    class ResourceSetOR;
+    class RunControlApplicationBase;
+    class SW_ExternalPackage;
+    class SW_Package;
+    class SW_Repository;
+    class Segment;
+    class TemplateApplication;
+    class TemplateSegment;
+    class Variable;
+    class VariableSet;
+
+    /**
+     * \brief Fast type tests of DAL objects used by the algorithms hot loops
+     *
+     *  The DalObject::cast() method uses dynamic_cast and, when it fails, looks up the class hierarchy
+     *  of the database schema by class names. Most of the algorithms loops test an object against
+     *  several classes and the negative answer is the most frequent one.
+     *
+     *  The class keeps for each database class a bitmask of DAL classes it can be casted to.
+     *  The masks are calculated once per class using DalObject::castable() and are found by address
+     *  of class name string of object (the names are shared by all objects of the same class).
+     *  The recently used masks are cached per thread, so the type test is a pointer comparison
+     *  plus a mask in most cases.
+     *
+     *  The masks are invalidated by reset(), that is called when a database is (re)loaded or unloaded.
+     *
+     *  \par Example
+     *
+     *  <pre><i>
+     *
+     *  for (const auto& i : rs.get_Contains())
+     *    if (const dunedaq::dal::ResourceSet * s = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(i))
+     *      process(*s);
+     *
+     *  </i></pre>
+     **/
+
+    class ClassMask
+    {
+
+    public:
+
+      enum Class : uint8_t {
+        ApplicationClass,
+        BaseApplicationClass,
+        ComponentClass,
+        ComputerClass,
+        ComputerSetClass,
+        InfrastructureApplicationClass,
+        InfrastructureBaseClass,
+        ParameterClass,
+        ResourceClass,
+        ResourceBaseClass,
+        ResourceSetClass,
+        ResourceSetANDClass,
+        ResourceSetORClass,
+        RunControlApplicationBaseClass,
+        SW_ExternalPackageClass,
+        SW_PackageClass,
+        SW_RepositoryClass,
+        SegmentClass,
+        TemplateApplicationClass,
+        TemplateSegmentClass,
+        VariableClass,
+        VariableSetClass,
+        NumOfClasses
+      };
+
+      /// Map DAL class to its bit.
+
+      template<class T>
+        struct Bit;
+
+
+      /// Get mask of classes the object can be casted to.
+
+      static uint32_t
+      get(const dunedaq::oksdbinterfaces::DalObject * obj)
+      {
+        const std::string * key = &obj->class_name();
+        Entry& e = s_cache[(reinterpret_cast<uintptr_t>(key) >> 4) % cache_size];
+
+        if (e.m_key == key && e.m_generation == s_generation.load(std::memory_order_relaxed))
+          return e.m_mask;
+
+        return update(e, obj);
+      }
+
+      /// Return true, if the object can be casted to the DAL class.
+
+      template<class T>
+        static bool
+        castable(const dunedaq::oksdbinterfaces::DalObject * obj)
+        {
+          return (get(obj) & (1U << Bit<T>::value)) != 0;
+        }
+
+      /// Cast object to the DAL class; return nullptr, if the object cannot be casted.
+
+      template<class T, class S>
+        static const T *
+        cast(const S * obj)
+        {
+          return (castable<T>(obj) ? obj->template cast<T>() : nullptr);
+        }
+
+      /// Invalidate calculated masks, e.g. when the database schema may change.
+
+      static void
+      reset()
+      {
+        s_generation.fetch_add(1, std::memory_order_relaxed);
+      }
+
+
+    private:
+
+      enum {
+        cache_size = 64
+      };
+
+      struct Entry
+      {
+        const std::string * m_key;
+        uint32_t m_generation;
+        uint32_t m_mask;
+      };
+
+      static uint32_t
+      update(Entry& e, const dunedaq::oksdbinterfaces::DalObject * obj);
+
+      static std::atomic<uint32_t> s_generation;
+      static thread_local Entry s_cache[cache_size];
+
+    };
+
+#define DAL_CLASS_MASK_BIT(C) template<> struct ClassMask::Bit<dunedaq::dal::C> { static constexpr ClassMask::Class value = ClassMask::C##Class; }
+
+    DAL_CLASS_MASK_BIT(Application);
+    DAL_CLASS_MASK_BIT(BaseApplication);
+    DAL_CLASS_MASK_BIT(Component);
+    DAL_CLASS_MASK_BIT(Computer);
+    DAL_CLASS_MASK_BIT(ComputerSet);
+    DAL_CLASS_MASK_BIT(InfrastructureApplication);
+    DAL_CLASS_MASK_BIT(InfrastructureBase);
+    DAL_CLASS_MASK_BIT(Parameter);
+    DAL_CLASS_MASK_BIT(Resource);
+    DAL_CLASS_MASK_BIT(ResourceBase);
+    DAL_CLASS_MASK_BIT(ResourceSet);
+    DAL_CLASS_MASK_BIT(ResourceSetAND);
+    DAL_CLASS_MASK_BIT(ResourceSetOR);
+    DAL_CLASS_MASK_BIT(RunControlApplicationBase);
+    DAL_CLASS_MASK_BIT(SW_ExternalPackage);
+    DAL_CLASS_MASK_BIT(SW_Package);
+    DAL_CLASS_MASK_BIT(SW_Repository);
+    DAL_CLASS_MASK_BIT(Segment);
+    DAL_CLASS_MASK_BIT(TemplateApplication);
+    DAL_CLASS_MASK_BIT(TemplateSegment);
+    DAL_CLASS_MASK_BIT(Variable);
+    DAL_CLASS_MASK_BIT(VariableSet);
+
+#undef DAL_CLASS_MASK_BIT
+
+} // namespace dunedaq::dal
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef _dal_environment_source_H_
+#define _dal_environment_source_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace dunedaq::dal {
+
+    /**
+     * \brief The process environment used by the DAL algorithms
+     *
+     *  The algorithms building application's launch information read the process environment: the TDAQ_DB_REPOSITORY,
+     *  TDAQ_DB_USER_REPOSITORY and OKS_REPOSITORY_MAPPING_DIR variables (see BaseApplication::get_info()) and the
+     *  $(NAME) references substituted by dunedaq::dal::substitute_variables() without conversion map.
+     *
+     *  The environment source is an immutable hashed map of names and values. By default the algorithms use
+     *  a snapshot of the process environment taken on first use; it can be replaced by set_default() (e.g.
+     *  by a new snapshot after the process environment was changed). A thread may use another source
+     *  (e.g. injected map of values) while a Scope object exists, so several environments can be used
+     *  by one process without changing the real one.
+     *
+     *  Each source has unique identity; the results depending on the environment (e.g. the front environment
+     *  of applications shared by the segments tree) are cached per source.
+     *
+     *  \par Example
+     *
+     *  <pre><i>
+     *
+     *  auto env = dunedaq::dal::EnvironmentSource::create({{"TDAQ_DB_REPOSITORY", "/repo"}, {"USER", "daq"}});
+     *
+     *  {
+     *    dunedaq::dal::EnvironmentSource::Scope scope(env);
+     *    app->get_info(environment, program_names, start_args, restart_args);
+     *  }
+     *
+     *  </i></pre>
+     **/
+
+    class EnvironmentSource
+    {
+
+    public:
+
+      typedef std::unordered_map<std::string, std::string> Values;
+
+
+      /// Create snapshot of the process environment.
+
+      static std::shared_ptr<const EnvironmentSource>
+      snapshot();
+
+      /// Create source from given values.
+
+      static std::shared_ptr<const EnvironmentSource>
+      create(Values values);
+
+
+      /// Get the source used by the algorithms in this thread (the one of innermost scope or the default).
+
+      static std::shared_ptr<const EnvironmentSource>
+      get();
+
+      /// Set the default source used by the algorithms, when there is no scope in the thread.
+
+      static void
+      set_default(std::shared_ptr<const EnvironmentSource> source);
+
+
+      /// Use the source by the algorithms in this thread while the object exists.
+
+      class Scope
+      {
+
+      public:
+
+        Scope(std::shared_ptr<const EnvironmentSource> source);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+
+        std::shared_ptr<const EnvironmentSource> m_previous;
+
+      };
+
+
+      /// Get value of variable or null pointer, if it is not defined.
+
+      const std::string *
+      find(const std::string& name) const
+      {
+        auto it = m_values.find(name);
+        return (it != m_values.end() ? &it->second : nullptr);
+      }
+
+      const Values&
+      get_values() const
+      {
+        return m_values;
+      }
+
+      /// Get unique identity of source.
+
+      uint64_t
+      get_id() const
+      {
+        return m_id;
+      }
+
+
+    private:
+
+      EnvironmentSource(Values&& values);
+
+      const Values m_values;
+      const uint64_t m_id;
+
+    };
+
+} // namespace dunedaq::dal
+
+#endif
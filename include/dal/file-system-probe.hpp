@@ -0,0 +1,67 @@
+#ifndef _dal_file_system_probe_H_
+#define _dal_file_system_probe_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace dunedaq::dal {
+
+    /**
+     * \brief Cache of directory listings used to test existence of files
+     *
+     *  The algorithms searching files in several areas (e.g. JAR files in the repository root, patch and
+     *  installation areas, see dunedaq::dal::add_classpath()) test existence of a file name in several directories
+     *  for every application. On shared network file systems each stat() call is expensive.
+     *
+     *  The class reads each directory once and answers existence queries from memory. The modification times of
+     *  the cached directories are checked at most once per check interval; a directory modified since it was read
+     *  is read again on next query. The refresh() method drops all listings at once.
+     *
+     *  The version is incremented each time any cached listing is dropped, so the results computed using
+     *  the probe (e.g. resolved class path) can be invalidated by comparing the versions.
+     *
+     *  The methods can be called by several threads.
+     **/
+
+    class FileSystemProbe
+    {
+
+    public:
+
+      /// the interval between checks of modification times of cached directories (in milliseconds)
+      static constexpr uint32_t check_interval = 1000;
+
+
+      /// Test if a file exists (the path must be absolute, e.g. "/dir/file"); a dangling symbolic link does not exist.
+
+      static bool
+      exists(const std::string& path);
+
+      /**
+       *  Remove non-existent and empty directories from the list of absolute paths keeping order of others.
+       *  A directory containing dangling symbolic links only is empty; a directory that cannot be read is kept.
+       *  The cached listings are looked up and the missing ones are added at once for whole list.
+       *
+       *  \return number of removed paths
+       */
+
+      static std::size_t
+      remove_empty_directories(std::vector<std::string>& paths);
+
+      /// Drop all cached listings.
+
+      static void
+      refresh() noexcept;
+
+      /// Check modification times of cached directories (if check interval expired) and return the version.
+
+      static uint64_t
+      get_version();
+
+    };
+
+} // namespace dunedaq::dal
+
+#endif
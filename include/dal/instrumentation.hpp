@@ -0,0 +1,254 @@
+#ifndef _dal_instrumentation_H_
+#define _dal_instrumentation_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <vector>
+
+namespace dunedaq::dal {
+
+    /**
+     * \brief The class implements counters and timers of the DAL hot paths
+     *
+     *  The instrumentation is compiled into the library, when it is built with the DAL_INSTRUMENTATION
+     *  preprocessor macro defined (e.g. cmake -DDAL_INSTRUMENTATION=ON); otherwise the probes in the algorithms
+     *  are empty macros and the snapshot contains zeroes.
+     *
+     *  For each probe the following counters are provided:
+     *  - number of calls and cumulative time (recursive calls of the same probe are counted once);
+     *  - number of cache hits and misses (where the algorithm uses a cache);
+     *  - number of generated objects (e.g. segments and applications of the control tree);
+     *  - number and size of heap allocations made by the probe and by the functions it calls.
+     *
+     *  The allocations are only counted by threads having an AllocationScope object, since the
+     *  instrumented library replaces global operator new and the counting is not free.
+     *
+     *  The counters are updated using relaxed atomic operations and can be read by any thread
+     *  using the get_snapshot() method.
+     *
+     *  \par Example
+     *
+     *  <pre><i>
+     *
+     *  for (const auto& x : dunedaq::dal::Instrumentation::get_snapshot())
+     *    std::cout << x.m_name << ": " << x.m_calls << " calls, " << x.m_time / 1000 << " us\n";
+     *
+     *  </i></pre>
+     **/
+
+    class Instrumentation
+    {
+
+    public:
+
+      enum Probe : uint8_t {
+        GetSegment,             ///< generation of the segments tree by Partition::get_segment()
+        Disabled,               ///< Component::disabled()
+        GetParents,             ///< Component::get_parents()
+        GetParameters,          ///< program names, search paths and shared libraries of program
+        GetPaths,               ///< search paths and shared libraries of software package closure
+        Environment,            ///< building of application process environment
+        Substitution,           ///< dunedaq::dal::substitute_variables()
+        AddClasspath,           ///< dunedaq::dal::add_classpath()
+        NumOfProbes
+      };
+
+      /// The values of probe counters.
+
+      struct Counters
+      {
+        const char * m_name;
+        uint64_t m_calls;
+        uint64_t m_time;       ///< cumulative time in nanoseconds
+        uint64_t m_hits;
+        uint64_t m_misses;
+        uint64_t m_objects;
+        uint64_t m_allocations;
+        uint64_t m_allocated_bytes;
+      };
+
+
+      /// Return true, if the library is built with instrumentation.
+
+      static bool
+      is_enabled();
+
+      /// Get name of probe.
+
+      static const char *
+      get_name(Probe probe);
+
+      /// Get values of all probe counters.
+
+      static std::vector<Counters>
+      get_snapshot();
+
+      /// Reset all counters.
+
+      static void
+      reset();
+
+      /// Print values of counters as table (the probes with zero calls are skipped).
+
+      static void
+      print(std::ostream& s);
+
+
+      static void
+      add_call(Probe probe, uint64_t time)
+      {
+        s_counters[probe].m_calls.fetch_add(1, std::memory_order_relaxed);
+        s_counters[probe].m_time.fetch_add(time, std::memory_order_relaxed);
+      }
+
+      static void
+      add_hit(Probe probe)
+      {
+        s_counters[probe].m_hits.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      static void
+      add_miss(Probe probe)
+      {
+        s_counters[probe].m_misses.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      static void
+      add_objects(Probe probe, uint64_t num)
+      {
+        s_counters[probe].m_objects.fetch_add(num, std::memory_order_relaxed);
+      }
+
+      static void
+      add_allocations(Probe probe, uint64_t num, uint64_t bytes)
+      {
+        s_counters[probe].m_allocations.fetch_add(num, std::memory_order_relaxed);
+        s_counters[probe].m_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+      }
+
+      /// Count heap allocation made by the calling thread (used by operator new of the instrumented library).
+
+      static void
+      count_allocation(size_t bytes)
+      {
+        if (s_track_allocations)
+          {
+            s_allocations++;
+            s_allocated_bytes += bytes;
+          }
+      }
+
+
+      /// Count heap allocations made by the calling thread while the object exists; the scopes can be nested.
+
+      class AllocationScope
+      {
+
+      public:
+
+        AllocationScope()
+        {
+          ++s_track_allocations;
+        }
+
+        ~AllocationScope()
+        {
+          --s_track_allocations;
+        }
+
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator=(const AllocationScope&) = delete;
+
+      };
+
+
+      /// Measure the time of the scope; the nested scopes of the same probe in the same thread are ignored.
+
+      class Timer
+      {
+
+      public:
+
+        Timer(Probe probe) :
+          m_probe(probe),
+          m_outer(s_depth[probe]++ == 0)
+        {
+          if (m_outer)
+            {
+              m_allocations = s_allocations;
+              m_allocated_bytes = s_allocated_bytes;
+              m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~Timer()
+        {
+          --s_depth[m_probe];
+
+          if (m_outer)
+            {
+              add_call(m_probe, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+
+              if (s_allocations != m_allocations)
+                add_allocations(m_probe, s_allocations - m_allocations, s_allocated_bytes - m_allocated_bytes);
+            }
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+      private:
+
+        const Probe m_probe;
+        const bool m_outer;
+        uint64_t m_allocations;
+        uint64_t m_allocated_bytes;
+        std::chrono::steady_clock::time_point m_start;
+
+      };
+
+
+    private:
+
+      struct AtomicCounters
+      {
+        std::atomic<uint64_t> m_calls;
+        std::atomic<uint64_t> m_time;
+        std::atomic<uint64_t> m_hits;
+        std::atomic<uint64_t> m_misses;
+        std::atomic<uint64_t> m_objects;
+        std::atomic<uint64_t> m_allocations;
+        std::atomic<uint64_t> m_allocated_bytes;
+      };
+
+      static AtomicCounters s_counters[NumOfProbes];
+      static thread_local uint32_t s_depth[NumOfProbes];
+
+      static thread_local uint32_t s_track_allocations;
+      static thread_local uint64_t s_allocations;
+      static thread_local uint64_t s_allocated_bytes;
+
+    };
+
+} // namespace dunedaq::dal
+
+
+#ifdef DAL_INSTRUMENTATION
+#define DAL_INSTRUMENT_JOIN2(A, B) A ## B
+#define DAL_INSTRUMENT_JOIN(A, B) DAL_INSTRUMENT_JOIN2(A, B)
+#define DAL_INSTRUMENT_SCOPE(PROBE) ::dunedaq::dal::Instrumentation::Timer DAL_INSTRUMENT_JOIN(__dal_instrument_timer_, __LINE__)(::dunedaq::dal::Instrumentation::PROBE)
+#define DAL_INSTRUMENT_HIT(PROBE) ::dunedaq::dal::Instrumentation::add_hit(::dunedaq::dal::Instrumentation::PROBE)
+#define DAL_INSTRUMENT_MISS(PROBE) ::dunedaq::dal::Instrumentation::add_miss(::dunedaq::dal::Instrumentation::PROBE)
+#define DAL_INSTRUMENT_OBJECTS(PROBE, NUM) ::dunedaq::dal::Instrumentation::add_objects(::dunedaq::dal::Instrumentation::PROBE, NUM)
+#else
+#define DAL_INSTRUMENT_SCOPE(PROBE)
+#define DAL_INSTRUMENT_HIT(PROBE)
+#define DAL_INSTRUMENT_MISS(PROBE)
+#define DAL_INSTRUMENT_OBJECTS(PROBE, NUM)
+#endif
+
+#endif
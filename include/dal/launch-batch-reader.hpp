@@ -0,0 +1,311 @@
+#ifndef _dal_launch_batch_reader_H_
+#define _dal_launch_batch_reader_H_
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace dunedaq::dal {
+
+    /**
+     * \brief The class decodes batch of resolved applications launch descriptions in place
+     *
+     *  The batch is produced by the dunedaq::dal::LaunchBatchWriter class. It contains for each application
+     *  the name, the host and backup hosts, the tag, the program names, the process environment and
+     *  the command line arguments. The reader does not copy or parse the strings; it returns views on
+     *  the buffer, that must not be released while the reader and the views are used.
+     *
+     *  The class is header-only and does not depend on the DAL library and the configuration, so it
+     *  can be used by agents receiving the batches.
+     *
+     *  The format is portable and versioned; all numbers are 32-bit unsigned little-endian integers:
+     *  <pre>
+     *    header:       magic "DALBATCH", version, number of applications, number of references,
+     *                  size of strings, size of batch, reserved
+     *    applications: name, host, tag, start args, restart args (as references),
+     *                  first and number of backup hosts, program names and environment name:value pairs
+     *                  in the references list
+     *    references:   offset and size of string
+     *    strings:      characters (not null-terminated)
+     *  </pre>
+     *
+     *  \par Example
+     *
+     *  <pre><i>
+     *
+     *  dunedaq::dal::LaunchBatchReader batch(data, size);
+     *
+     *  for (uint32_t i = 0; i < batch.get_num_of_applications(); ++i) {
+     *    const dunedaq::dal::LaunchBatchReader::Application app(batch.get_application(i));
+     *    if (app.get_host() == my_host)
+     *      for (uint32_t j = 0; j < app.get_num_of_environment(); ++j)
+     *        setenv(std::string(app.get_environment_name(j)).c_str(), std::string(app.get_environment_value(j)).c_str(), 1);
+     *    ...
+     *  }
+     *
+     *  </i></pre>
+     **/
+
+    class LaunchBatchReader
+    {
+
+    public:
+
+      /// the version of batch format; increase it on any change of the layout
+      static constexpr uint32_t format_version = 1;
+
+      static constexpr char magic[8] = { 'D', 'A', 'L', 'B', 'A', 'T', 'C', 'H' };
+
+      /// the sizes of header, application record and reference (in 32-bit words)
+      static constexpr uint32_t header_size = 8;
+      static constexpr uint32_t application_size = 16;
+      static constexpr uint32_t reference_size = 2;
+
+      /// the positions of header fields (in 32-bit words, the magic uses first two)
+      enum HeaderField : uint32_t {
+        h_version = 2,
+        h_num_of_apps,
+        h_num_of_refs,
+        h_strings_size,
+        h_size,
+        h_reserved
+      };
+
+      /// the positions of application record fields (in 32-bit words; the strings use two words)
+      enum ApplicationField : uint32_t {
+        a_name = 0,
+        a_host = 2,
+        a_tag = 4,
+        a_start_args = 6,
+        a_restart_args = 8,
+        a_backup_hosts = 10,
+        a_num_of_backup_hosts,
+        a_program_names,
+        a_num_of_program_names,
+        a_environment,
+        a_num_of_environment
+      };
+
+
+      /// Read little-endian 32-bit word.
+
+      static uint32_t
+      read32(const unsigned char * p)
+      {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        v = __builtin_bswap32(v);
+#endif
+        return v;
+      }
+
+
+      /// The view on application record.
+
+      class Application
+      {
+
+        friend class LaunchBatchReader;
+
+      public:
+
+        std::string_view get_name() const { return m_batch.get_string(m_data + a_name * 4); }
+        std::string_view get_host() const { return m_batch.get_string(m_data + a_host * 4); }
+        std::string_view get_tag() const { return m_batch.get_string(m_data + a_tag * 4); }
+        std::string_view get_start_args() const { return m_batch.get_string(m_data + a_start_args * 4); }
+        std::string_view get_restart_args() const { return m_batch.get_string(m_data + a_restart_args * 4); }
+
+        // the index must be less than corresponding number (checked by debug builds only)
+
+        uint32_t get_num_of_backup_hosts() const { return get(a_num_of_backup_hosts); }
+        std::string_view get_backup_host(uint32_t idx) const { assert(idx < get_num_of_backup_hosts()); return m_batch.get_ref(get(a_backup_hosts) + idx); }
+
+        uint32_t get_num_of_program_names() const { return get(a_num_of_program_names); }
+        std::string_view get_program_name(uint32_t idx) const { assert(idx < get_num_of_program_names()); return m_batch.get_ref(get(a_program_names) + idx); }
+
+        uint32_t get_num_of_environment() const { return get(a_num_of_environment); }
+        std::string_view get_environment_name(uint32_t idx) const { assert(idx < get_num_of_environment()); return m_batch.get_ref(get(a_environment) + 2 * idx); }
+        std::string_view get_environment_value(uint32_t idx) const { assert(idx < get_num_of_environment()); return m_batch.get_ref(get(a_environment) + 2 * idx + 1); }
+
+        /// Get backup host; throw std::out_of_range, if the index is out of range.
+
+        std::string_view
+        at_backup_host(uint32_t idx) const
+        {
+          check_index(idx, get_num_of_backup_hosts(), "backup host");
+          return get_backup_host(idx);
+        }
+
+        /// Get program name; throw std::out_of_range, if the index is out of range.
+
+        std::string_view
+        at_program_name(uint32_t idx) const
+        {
+          check_index(idx, get_num_of_program_names(), "program name");
+          return get_program_name(idx);
+        }
+
+        /// Get environment variable name and value; throw std::out_of_range, if the index is out of range.
+
+        std::pair<std::string_view, std::string_view>
+        at_environment(uint32_t idx) const
+        {
+          check_index(idx, get_num_of_environment(), "environment variable");
+          return std::make_pair(get_environment_name(idx), get_environment_value(idx));
+        }
+
+
+      private:
+
+        Application(const LaunchBatchReader& batch, const unsigned char * data) :
+          m_batch(batch), m_data(data)
+        {
+          ;
+        }
+
+        uint32_t
+        get(ApplicationField field) const
+        {
+          return read32(m_data + field * 4);
+        }
+
+        const LaunchBatchReader& m_batch;
+        const unsigned char * m_data;
+
+      };
+
+
+      /**
+       *  \brief Check the batch and prepare to read it.
+       *
+       *  All references are validated, so the accessors do not check them. The indexes passed to the get_*() accessors
+       *  are checked by assertions only; the at_*() accessors check them at run time.
+       *
+       *  \param data  the batch (no alignment is required)
+       *  \param size  the size of batch
+       *
+       *  \throw std::runtime_error if the batch is corrupted or has unsupported version
+       */
+
+      LaunchBatchReader(const void * data, size_t size) :
+        m_data(static_cast<const unsigned char *>(data))
+      {
+        if (size < header_size * 4 || memcmp(m_data, magic, sizeof(magic)) != 0)
+          throw std::runtime_error("the data is not a launch batch");
+
+        if (read32(m_data + h_version * 4) != format_version)
+          throw std::runtime_error("the launch batch format version " + std::to_string(read32(m_data + h_version * 4)) + " is not supported (expected " + std::to_string(format_version) + ')');
+
+        m_num_of_apps = read32(m_data + h_num_of_apps * 4);
+        m_num_of_refs = read32(m_data + h_num_of_refs * 4);
+        m_strings_size = read32(m_data + h_strings_size * 4);
+
+        if (read32(m_data + h_size * 4) != size || get_size(m_num_of_apps, m_num_of_refs, m_strings_size) != size)
+          throw std::runtime_error("the launch batch size does not match to its header (truncated data?)");
+
+        m_apps = m_data + header_size * 4;
+        m_refs = m_apps + static_cast<uint64_t>(m_num_of_apps) * application_size * 4;
+        m_strings = reinterpret_cast<const char *>(m_refs + static_cast<uint64_t>(m_num_of_refs) * reference_size * 4);
+
+        for (uint32_t i = 0; i < m_num_of_refs; ++i)
+          check_string(m_refs + i * reference_size * 4);
+
+        for (uint32_t i = 0; i < m_num_of_apps; ++i)
+          {
+            const unsigned char * a = m_apps + i * application_size * 4;
+
+            for (auto x : { a_name, a_host, a_tag, a_start_args, a_restart_args })
+              check_string(a + x * 4);
+
+            if (static_cast<uint64_t>(read32(a + a_backup_hosts * 4)) + read32(a + a_num_of_backup_hosts * 4) > m_num_of_refs ||
+                static_cast<uint64_t>(read32(a + a_program_names * 4)) + read32(a + a_num_of_program_names * 4) > m_num_of_refs ||
+                static_cast<uint64_t>(read32(a + a_environment * 4)) + 2 * static_cast<uint64_t>(read32(a + a_num_of_environment * 4)) > m_num_of_refs)
+              throw std::runtime_error("bad application record in launch batch");
+          }
+      }
+
+
+      /// Throw std::out_of_range, if the index is out of range.
+
+      static void
+      check_index(uint32_t idx, uint32_t num, const char * what)
+      {
+        if (idx >= num)
+          throw std::out_of_range(std::string("bad ") + what + " index " + std::to_string(idx) + " in launch batch (size " + std::to_string(num) + ')');
+      }
+
+
+      /// Get size of batch.
+
+      static uint64_t
+      get_size(uint64_t num_of_apps, uint64_t num_of_refs, uint64_t strings_size)
+      {
+        return (header_size + num_of_apps * application_size + num_of_refs * reference_size) * 4 + strings_size;
+      }
+
+      uint32_t
+      get_num_of_applications() const
+      {
+        return m_num_of_apps;
+      }
+
+      /// Get application; the index must be less than number of applications (checked by debug builds only).
+
+      Application
+      get_application(uint32_t idx) const
+      {
+        assert(idx < m_num_of_apps);
+        return Application(*this, m_apps + static_cast<uint64_t>(idx) * application_size * 4);
+      }
+
+      /// Get application; throw std::out_of_range, if the index is out of range.
+
+      Application
+      at_application(uint32_t idx) const
+      {
+        check_index(idx, m_num_of_apps, "application");
+        return get_application(idx);
+      }
+
+
+    private:
+
+      std::string_view
+      get_string(const unsigned char * ref) const
+      {
+        return std::string_view(m_strings + read32(ref), read32(ref + 4));
+      }
+
+      std::string_view
+      get_ref(uint32_t idx) const
+      {
+        return get_string(m_refs + idx * reference_size * 4);
+      }
+
+      void
+      check_string(const unsigned char * ref) const
+      {
+        if (static_cast<uint64_t>(read32(ref)) + read32(ref + 4) > m_strings_size)
+          throw std::runtime_error("bad string reference in launch batch");
+      }
+
+      const unsigned char * m_data;
+      const unsigned char * m_apps;
+      const unsigned char * m_refs;
+      const char * m_strings;
+
+      uint32_t m_num_of_apps;
+      uint32_t m_num_of_refs;
+      uint32_t m_strings_size;
+
+    };
+
+} // namespace dunedaq::dal
+
+#endif
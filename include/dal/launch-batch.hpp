@@ -0,0 +1,96 @@
+#ifndef _dal_launch_batch_H_
+#define _dal_launch_batch_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dal/launch-batch-reader.hpp"
+
+namespace dunedaq::dal {
+
+      // forward declarations
+
+    class BaseApplication;
+
+    /**
+     * \brief The class encodes batch of resolved applications launch descriptions
+     *
+     *  The batch is a flat buffer with offsets described by dunedaq::dal::LaunchBatchReader, which reads it
+     *  in place. The same encoded batch can be sent to agents on many hosts, which do not need to parse
+     *  the fields. Equal strings (e.g. common environment of applications) are stored once.
+     *
+     *  \par Example
+     *
+     *  <pre><i>
+     *
+     *  dunedaq::dal::LaunchBatchWriter writer;
+     *
+     *  for (const auto& a : root_segment->get_all_applications())
+     *    writer.add(*a);
+     *
+     *  const std::string batch = writer.encode();
+     *
+     *  </i></pre>
+     **/
+
+    class LaunchBatchWriter
+    {
+
+    public:
+
+      /// Add launch description of application.
+
+      void
+      add(const std::string& name, const std::string& host, const std::vector<std::string>& backup_hosts, const std::string& tag,
+          const std::vector<std::string>& program_names, const std::map<std::string, std::string>& environment,
+          const std::string& start_args, const std::string& restart_args);
+
+      /**
+       *  \brief Add launch description of application calculated by the BaseApplication::get_info() algorithm.
+       *
+       *  \throw dunedaq::dal::AlgorithmError in case of problems
+       */
+
+      void
+      add(const dunedaq::dal::BaseApplication& app);
+
+      /// Get number of added applications.
+
+      uint32_t
+      get_num_of_applications() const
+      {
+        return m_apps.size() / LaunchBatchReader::application_size;
+      }
+
+      /**
+       *  \brief Encode the batch.
+       *
+       *  \throw dunedaq::dal::AlgorithmError if the batch exceeds 4 GB
+       */
+
+      std::string
+      encode() const;
+
+
+    private:
+
+      void
+      add_string(const std::string& s, std::vector<uint32_t>& out);
+
+      void
+      add_list(const std::vector<std::string>& values);
+
+      std::vector<uint32_t> m_apps;
+      std::vector<uint32_t> m_refs;
+      std::string m_strings;
+      std::unordered_map<std::string, uint32_t> m_index;
+
+    };
+
+} // namespace dunedaq::dal
+
+#endif
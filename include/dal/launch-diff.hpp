@@ -0,0 +1,73 @@
+#ifndef _dal_launch_diff_H_
+#define _dal_launch_diff_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace dunedaq::dal {
+
+      // forward declarations
+
+    class LaunchPlan;
+
+    /**
+     * \brief The class describes difference of launch description of single application between two launch plans
+     *
+     *  An application is identified by its identity (the UID of normal application or generated identity of
+     *  template application). An application present in one plan only is reported as added or removed.
+     *  For an application present in both plans, each changed property is reported as a field with
+     *  old and new values. The field names are:
+     *  - "host" - the identity of application host;
+     *  - "backup-hosts" - the identities of backup hosts separated by space;
+     *  - "program-names" - the possible program names separated by colon;
+     *  - "start-args", "restart-args" - the command line arguments;
+     *  - "environment:NAME" - the value of process environment variable NAME (empty, if the variable is not set).
+     **/
+
+    struct AppLaunchDiff
+    {
+      enum Status : uint8_t {
+        Added,
+        Removed,
+        Changed
+      };
+
+      struct Field
+      {
+        std::string m_name;
+        std::string m_old_value;
+        std::string m_new_value;
+      };
+
+      std::string m_id;
+      Status m_status;
+      std::vector<Field> m_fields;    ///< changed properties; empty for added and removed applications
+
+      /// Print the difference in human-readable form.
+
+      void
+      print(std::ostream& s) const;
+    };
+
+
+    /**
+     *  \brief Compare launch descriptions of applications.
+     *
+     *  The plans are usually produced for two versions of configuration of the same partition. The operator
+     *  only needs to restart applications reported by the algorithm. The plans have to be produced with the
+     *  same variables substitution mode, otherwise all applications with database parameters are reported.
+     *
+     *  \param from  the launch plan of running configuration
+     *  \param to    the launch plan of new configuration
+     *  \return the differences of changed, added and removed applications in order of the "to" plan followed by removed applications
+     */
+
+    std::vector<AppLaunchDiff>
+    compare_launch_plans(const LaunchPlan& from, const LaunchPlan& to);
+
+} // namespace dunedaq::dal
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef _dal_launch_options_H_
+#define _dal_launch_options_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <ostream>
+#include <string>
+
+namespace dunedaq::dal {
+
+    /**
+     * \brief Optional modes of the application's get_info() algorithms
+     *
+     *  By default the get_info() algorithms return all candidate directories and program names as defined by
+     *  the configuration. The options allow to check them on the file system, so the launched processes
+     *  do not pay for lookups in missing directories:
+     *  - PrunePaths: remove non-existent and empty directories from PATH and LD_LIBRARY_PATH keeping their order
+     *    (enabled by the DAL_PRUNE_PATHS process environment variable)
+     *  - LibraryView: replace directories of LD_LIBRARY_PATH by single view directory with symbolic links to the
+     *    shared libraries (see dunedaq::dal::LibraryView); the views are created in a local directory defined by the
+     *    DAL_LIBRARY_VIEW_DIR process environment variable or by set_library_view_dir()
+     *  - ResolvePrograms: return single program name, i.e. the first candidate which is an executable regular file, instead of all
+     *    candidates; throw dunedaq::dal::NoProgramFile, if there is no such file (enabled by the
+     *    DAL_RESOLVE_PROGRAMS process environment variable)
+     *
+     *  The existence of directories is tested using the cached listings of dunedaq::dal::FileSystemProbe.
+     *  The options can also be changed by set() method; they are applied to next get_info() calls.
+     *  Since the results depend on the options and on the file system, the dunedaq::dal::AppInfoCache does not
+     *  cache them, when any option is enabled, and the dunedaq::dal::LaunchPlan inputs include get_state().
+     *  The results of pruning are counted and can be reported by print().
+     **/
+
+    class LaunchOptions
+    {
+
+    public:
+
+      enum Option : uint32_t {
+        PrunePaths = 0x1,
+        LibraryView = 0x2,
+        ResolvePrograms = 0x4
+      };
+
+      /// Get state of option.
+
+      static bool
+      is_set(Option option)
+      {
+        return (s_options.load(std::memory_order_relaxed) & option);
+      }
+
+      /// Test if any option is enabled.
+
+      static bool
+      is_any_set()
+      {
+        return (s_options.load(std::memory_order_relaxed) != 0);
+      }
+
+      /// Enable or disable option.
+
+      static void
+      set(Option option, bool value = true);
+
+      /// Get directory of shared libraries views.
+
+      static const std::string&
+      get_library_view_dir()
+      {
+        return s_library_view_dir;
+      }
+
+      /// Set directory of shared libraries views and enable LibraryView option (disable, if empty); not thread-safe, call before get_info().
+
+      static void
+      set_library_view_dir(const std::string& dir);
+
+
+      /// Get enabled options and the directory of views as printable text (empty, if there are no options).
+
+      static std::string
+      get_state();
+
+
+      /// Counters of pruned PATH and LD_LIBRARY_PATH directories.
+
+      struct PathsReport
+      {
+        uint64_t m_paths;          ///< number of candidate directories
+        uint64_t m_pruned;         ///< number of removed directories
+        uint64_t m_pruned_bytes;   ///< length of removed directories in the variables values
+      };
+
+      /// Count results of pruning.
+
+      static void
+      add_pruned(uint64_t paths, uint64_t pruned, uint64_t pruned_bytes)
+      {
+        s_paths.fetch_add(paths, std::memory_order_relaxed);
+        s_pruned.fetch_add(pruned, std::memory_order_relaxed);
+        s_pruned_bytes.fetch_add(pruned_bytes, std::memory_order_relaxed);
+      }
+
+      static PathsReport
+      get_paths_report();
+
+      static void
+      reset();
+
+      /// Print enabled options and results of pruning.
+
+      static void
+      print(std::ostream& s);
+
+
+    private:
+
+      static std::atomic<uint32_t> s_options;
+      static std::atomic<uint64_t> s_paths;
+      static std::atomic<uint64_t> s_pruned;
+      static std::atomic<uint64_t> s_pruned_bytes;
+      static std::string s_library_view_dir;
+
+    };
+
+} // namespace dunedaq::dal
+
+#endif
@@ -0,0 +1,298 @@
+#ifndef _dal_launch_plan_H_
+#define _dal_launch_plan_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dunedaq::dal {
+
+      // forward declarations
+
+    class AppInfoCache;
+    class Partition;
+
+    /**
+     * \brief The class describes precompiled launch plan of partition stored in binary snapshot file
+     *
+     *  The launch plan contains fully resolved partition: segments tree, applications with their hosts,
+     *  environment, possible program names and command line arguments, and the hosts described by the configuration.
+     *  It is written once by the write() method and then memory-mapped by readers, that do not need to load the
+     *  configuration database while it is not changed.
+     *
+     *  The snapshot is keyed by the partition name and the configuration version returned by the
+     *  dunedaq::dal::get_config_version() algorithm (i.e. TDAQ_DB_VERSION). Since the values of database
+     *  string attributes depend on the dunedaq::dal::SubstituteVariables converter, the key also includes
+     *  the substitution flag. The plan also depends on the inputs not described by the configuration version:
+     *  the database name, the local host name (used by segments without computers), the process environment
+     *  read by the algorithms and the enabled dunedaq::dal::LaunchOptions (e.g. the resolved program names); they are returned by make_inputs(),
+     *  stored in the snapshot and their hash is a part of the file name. Use get_file_name() to build the name
+     *  of snapshot file for given key.
+     *
+     *  The file format is native (not portable between platforms with different byte order) and versioned;
+     *  the files produced by another format version or platform are rejected.
+     *
+     *  \par Example
+     *
+     *  <pre><i>
+     *
+     *  const std::string inputs = dunedaq::dal::LaunchPlan::make_inputs(db_name);
+     *  const std::string file = dunedaq::dal::LaunchPlan::get_file_name(dir, partition_name, dunedaq::dal::get_config_version(partition_name), true, inputs);
+     *  std::unique_ptr<dunedaq::dal::LaunchPlan> plan = dunedaq::dal::LaunchPlan::open(file, partition_name, dunedaq::dal::get_config_version(partition_name), true, inputs);
+     *
+     *  if (!plan) {
+     *    dunedaq::oksdbinterfaces::Configuration db(...);
+     *    ...
+     *    db.register_converter(new dunedaq::dal::SubstituteVariables(*partition));
+     *    dunedaq::dal::LaunchPlan::write(file, *partition, dunedaq::dal::get_config_version(partition_name), true, inputs);
+     *    plan = dunedaq::dal::LaunchPlan::open(file, partition_name, dunedaq::dal::get_config_version(partition_name), true, inputs);
+     *  }
+     *
+     *  </i></pre>
+     **/
+
+    class LaunchPlan
+    {
+
+    public:
+
+      /// the value used for undefined index (e.g. parent of root segment or application without host)
+      static constexpr uint32_t npos = UINT32_MAX;
+
+      /// the version of snapshot file format; increase it on any change of the records layout
+      static constexpr uint32_t format_version = 3;
+
+      /// the reference on string stored in the snapshot
+      struct StringRef
+      {
+        uint32_t m_offset;
+        uint32_t m_size;
+      };
+
+      /// the segment record; the segments are stored in pre-order of the tree
+      struct SegmentRecord
+      {
+        StringRef m_id;
+        uint32_t m_parent;
+        uint8_t m_enabled;
+        uint8_t m_templated;
+        uint8_t m_reserved[2];
+      };
+
+      /// the host record
+      struct HostRecord
+      {
+        StringRef m_id;
+        StringRef m_rlogin;
+        StringRef m_hw_tag;
+      };
+
+      /// the application record; the applications are stored in order of the Partition::get_all_applications() algorithm
+      struct ApplicationRecord
+      {
+        StringRef m_id;
+        StringRef m_base_app_id;       ///< id of the original base application object
+        StringRef m_base_app_name;     ///< the base application object printed as "'id@class'"
+        StringRef m_class_name;
+        StringRef m_lifetime;          ///< the CustomLifetimeApplicationBase Lifetime attribute (empty, if not defined)
+        StringRef m_start_args;
+        StringRef m_restart_args;
+        uint32_t m_segment;
+        uint32_t m_host;
+        uint32_t m_program_names;      ///< index of first program name in the references list
+        uint32_t m_num_of_program_names;
+        uint32_t m_environment;        ///< index of first name:value pair in the references list
+        uint32_t m_num_of_environment;
+        uint32_t m_backup_hosts;       ///< index of first backup host id in the references list
+        uint32_t m_num_of_backup_hosts;
+        uint8_t m_templated;
+        uint8_t m_restartable;         ///< the application is restarted if fails to start or exits unexpectedly
+        uint8_t m_reserved[2];
+      };
+
+
+      /**
+       *  \brief Get inputs of launch plan, that are not described by the configuration version.
+       *
+       *  The result contains the database name, the local host name and the values of process environment variables read by the algorithms
+       *  (TDAQ_DB_REPOSITORY, TDAQ_DB_USER_REPOSITORY and OKS_REPOSITORY_MAPPING_DIR) taken from the environment source
+       *  of the calling thread (see dunedaq::dal::EnvironmentSource) and the state of dunedaq::dal::LaunchOptions.
+       *  Set the options before the call.
+       *
+       *  \param database  the name of the database (if empty, the value of TDAQ_DB process environment variable is used)
+       *  \return the inputs as printable text
+       */
+
+      static std::string
+      make_inputs(const std::string& database);
+
+
+      /**
+       *  \brief Get name of snapshot file.
+       *
+       *  \param dir             the directory of snapshot files
+       *  \param partition       the name of partition
+       *  \param config_version  the configuration version
+       *  \param substituted     true, if database parameters are substituted
+       *  \param inputs          the inputs returned by make_inputs()
+       *  \return the name of snapshot file
+       */
+
+      static std::string
+      get_file_name(const std::string& dir, const std::string& partition, const std::string& config_version, bool substituted, const std::string& inputs);
+
+
+      /**
+       *  \brief Compute launch plan of partition and write it to snapshot file.
+       *
+       *  The file is written under temporary name and renamed, so concurrent readers never see partially written snapshot.
+       *  The dunedaq::dal::SubstituteVariables converter has to be registered, if the substituted parameter is true.
+       *  If the cache is provided, the applications info is read from it when their dependencies are not changed.
+       *
+       *  \param file_name       the name of snapshot file
+       *  \param partition       the partition object
+       *  \param config_version  the configuration version
+       *  \param substituted     true, if database parameters are substituted
+       *  \param inputs          the inputs returned by make_inputs()
+       *  \param cache           optional persistent cache of applications info
+       *
+       *  \throw dunedaq::dal::AlgorithmError in case of problems (e.g. get_info() failed for an application)
+       *  \throw dunedaq::dal::BadLaunchPlan if the file cannot be written
+       */
+
+      static void
+      write(const std::string& file_name, const dunedaq::dal::Partition& partition, const std::string& config_version, bool substituted, const std::string& inputs, dunedaq::dal::AppInfoCache * cache = nullptr);
+
+
+      /**
+       *  \brief Open snapshot file.
+       *
+       *  \param file_name       the name of snapshot file
+       *  \param partition       the name of partition
+       *  \param config_version  the configuration version
+       *  \param substituted     true, if database parameters are substituted
+       *  \param inputs          the inputs returned by make_inputs()
+       *  \return the launch plan or null, if the file does not exist
+       *
+       *  \throw dunedaq::dal::BadLaunchPlan if the file cannot be read, it is corrupted or it was produced for another key
+       */
+
+      static std::unique_ptr<LaunchPlan>
+      open(const std::string& file_name, const std::string& partition, const std::string& config_version, bool substituted, const std::string& inputs);
+
+
+      /// Memory-map snapshot file; throw dunedaq::dal::BadLaunchPlan in case of problems.
+
+      LaunchPlan(const std::string& file_name);
+
+      ~LaunchPlan();
+
+      LaunchPlan(const LaunchPlan&) = delete;
+      LaunchPlan& operator=(const LaunchPlan&) = delete;
+
+
+      const std::string&
+      get_file_name() const
+      {
+        return m_file_name;
+      }
+
+      std::string_view
+      get_partition() const;
+
+      std::string_view
+      get_config_version() const;
+
+      bool
+      get_substituted() const;
+
+      std::string_view
+      get_inputs() const;
+
+      std::string_view
+      get_string(const StringRef& ref) const
+      {
+        return std::string_view(m_strings + ref.m_offset, ref.m_size);
+      }
+
+      uint32_t
+      get_num_of_segments() const
+      {
+        return m_num_of_segments;
+      }
+
+      const SegmentRecord&
+      get_segment(uint32_t idx) const
+      {
+        return m_segments[idx];
+      }
+
+      uint32_t
+      get_num_of_hosts() const
+      {
+        return m_num_of_hosts;
+      }
+
+      const HostRecord&
+      get_host(uint32_t idx) const
+      {
+        return m_hosts[idx];
+      }
+
+      uint32_t
+      get_num_of_applications() const
+      {
+        return m_num_of_apps;
+      }
+
+      const ApplicationRecord&
+      get_application(uint32_t idx) const
+      {
+        return m_apps[idx];
+      }
+
+      /// Get possible program names of application.
+
+      std::vector<std::string>
+      get_program_names(const ApplicationRecord& app) const;
+
+      /// Get process environment of application.
+
+      std::map<std::string, std::string>
+      get_environment(const ApplicationRecord& app) const;
+
+      /// Get identities of application backup hosts.
+
+      std::vector<std::string>
+      get_backup_hosts(const ApplicationRecord& app) const;
+
+      /// Find application by identity; return npos, if there is no such application.
+
+      uint32_t
+      find_application(std::string_view id) const;
+
+
+    private:
+
+      std::string m_file_name;
+      void * m_data;
+      size_t m_size;
+
+      uint32_t m_num_of_segments;
+      uint32_t m_num_of_hosts;
+      uint32_t m_num_of_apps;
+
+      const SegmentRecord * m_segments;
+      const HostRecord * m_hosts;
+      const ApplicationRecord * m_apps;
+      const StringRef * m_refs;
+      const char * m_strings;
+
+    };
+} // namespace dunedaq::dal
+
+#endif
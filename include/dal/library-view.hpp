@@ -0,0 +1,51 @@
+#ifndef _dal_library_view_H_
+#define _dal_library_view_H_
+
+#include <string>
+#include <vector>
+
+namespace dunedaq::dal {
+
+    /**
+     * \brief Local view directories of shared libraries
+     *
+     *  The LD_LIBRARY_PATH built by the get_info() algorithms contains lib directories of all used repositories
+     *  (patch and installation areas of each). The dynamic loader searches all of them for every needed library.
+     *
+     *  The class creates a local directory containing symbolic links to the shared libraries found in such ordered
+     *  list of directories. For each library name the link points to the file in the first directory where it
+     *  exists, i.e. the loader finds the same library as it finds using the original list. The list can be replaced
+     *  by single view directory.
+     *
+     *  The views are created in the directory defined by the dunedaq::dal::LaunchOptions::get_library_view_dir().
+     *  The name of view is built from the tag, the hash of the ordered list of directories and the hash of their
+     *  modification times, so a new view is created when any library is added or removed. Old views are not removed.
+     *  A view is created in a temporary directory and renamed, so several processes can create it concurrently.
+     *
+     *  The names of views are cached in memory and are checked when the dunedaq::dal::FileSystemProbe version
+     *  changes. The methods can be called by several threads.
+     **/
+
+    class LibraryView
+    {
+
+    public:
+
+      /**
+       *  Get path to the view of shared libraries from ordered list of directories; create it if needed.
+       *
+       *  \param dirs   ordered list of absolute paths to the directories
+       *  \param tag    id of the tag the directories are built for
+       *
+       *  \return path to the view directory
+       *  \throw dunedaq::dal::BadLibraryView in case of a problem
+       */
+
+      static std::string
+      get(const std::vector<std::string>& dirs, const std::string& tag);
+
+    };
+
+} // namespace dunedaq::dal
+
+#endif
@@ -0,0 +1,340 @@
+#ifndef _dal_partition_image_H_
+#define _dal_partition_image_H_
+
+#include <stdint.h>
+
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dunedaq::dal {
+
+      // forward declarations
+
+    class BaseApplication;
+    class Computer;
+    class Segment;
+
+    /**
+     * \brief The class describes read-only compiled image of generated partition segments tree
+     *
+     *  The image is built by the dunedaq::dal::Partition::get_segment() algorithm after generation of the segments tree
+     *  and is released together with it. It stores the tree as structure of arrays indexed by segment and application
+     *  numbers, so that whole-partition queries are linear scans over contiguous memory instead of recursive walks
+     *  over SegConfig and AppConfig objects.
+     *
+     *  The segments are numbered in pre-order of the tree (the root segment has index 0), so any subtree occupies
+     *  a contiguous range of segment indices. The applications of enabled segments are stored in the same order as
+     *  they are returned by the dunedaq::dal::Segment::get_all_applications() algorithm (controller, infrastructure,
+     *  applications, then applications of nested segments); the applications of any subtree also occupy a contiguous
+     *  range of application indices.
+     *
+     *  The arrays are allocated from the arena of the segments tree generation.
+     **/
+
+    class PartitionImage
+    {
+
+      friend class AlgorithmUtils;
+
+    public:
+
+      /// the value used for undefined index (e.g. parent of root segment)
+      static constexpr uint32_t npos = UINT32_MAX;
+
+      /// application's role in the segment
+      enum Role : uint8_t {
+        Controller = 0,
+        Infrastructure = 1,
+        Application = 2
+      };
+
+      /// application's lifetime (see dunedaq::dal::CustomLifetimeApplicationBase::Lifetime; NoLifetime is used for other applications)
+      enum Lifetime : uint8_t {
+        NoLifetime = 0,
+        BootShutdown = 1,
+        ConfigureUnconfigure = 2,
+        SorEor = 3,
+        EorSor = 4,
+        UserDefinedShutdown = 5,
+        NumOfLifetimes
+      };
+
+      /**
+       *  The application category combines lifetime and restartable flag (an application is restartable,
+       *  if it is restarted when it exits unexpectedly or fails to start); the category is a number in range [0, 12).
+       *  The category mask has bit (1 << category) set for every category of interest.
+       */
+
+      typedef uint16_t CategoryMask;
+
+      /// number of categories
+      static constexpr uint32_t num_of_categories = NumOfLifetimes * 2;
+
+      /// mask of all categories
+      static constexpr CategoryMask all_categories = (1 << num_of_categories) - 1;
+
+      /// mask of categories of non-restartable applications
+      static constexpr CategoryMask non_restartable_categories = 0x555;
+
+      /// Get category of application by lifetime and restartable flag.
+
+      static constexpr uint8_t
+      get_category(Lifetime lifetime, bool restartable)
+      {
+        return lifetime * 2 + restartable;
+      }
+
+      /// Get mask of categories of applications with given lifetime.
+
+      static constexpr CategoryMask
+      get_lifetime_categories(Lifetime lifetime)
+      {
+        return 3 << (lifetime * 2);
+      }
+
+      /// Get lifetime by value of CustomLifetimeApplicationBase's attribute (NoLifetime for empty or unknown value).
+
+      static Lifetime
+      get_lifetime(std::string_view value);
+
+      PartitionImage(std::pmr::memory_resource * mr) :
+        m_segments(mr), m_seg_parent(mr), m_seg_children_idx(mr), m_seg_children(mr), m_seg_apps_begin(mr), m_seg_apps_end(mr), m_seg_enabled(mr), m_seg_templated(mr),
+        m_apps(mr), m_app_segment(mr), m_app_host(mr), m_app_class(mr), m_app_role(mr), m_app_category(mr),
+        m_hosts(mr), m_host_categories(mr), m_host_first_app(mr), m_class_names(mr)
+      {
+        ;
+      }
+
+
+      /// Get number of segments.
+
+      uint32_t
+      get_num_of_segments() const
+      {
+        return m_segments.size();
+      }
+
+      /// Get generated segment objects by segment index.
+
+      const std::pmr::vector<const Segment *>&
+      get_segments() const
+      {
+        return m_segments;
+      }
+
+      /// Get parent segment index by segment index (npos for the root segment).
+
+      const std::pmr::vector<uint32_t>&
+      get_segment_parents() const
+      {
+        return m_seg_parent;
+      }
+
+      /**
+       *  Get nested segments of segment in CSR format:
+       *  the indices of nested segments of segment \e i are stored in get_segment_children() array
+       *  between get_segment_children_index()[i] and get_segment_children_index()[i+1].
+       */
+
+      const std::pmr::vector<uint32_t>&
+      get_segment_children_index() const
+      {
+        return m_seg_children_idx;
+      }
+
+      const std::pmr::vector<uint32_t>&
+      get_segment_children() const
+      {
+        return m_seg_children;
+      }
+
+      /**
+       *  Get range of applications of segment subtree:
+       *  the applications of segment \e i and of its nested segments have indices in range
+       *  [ get_segment_apps_begin()[i], get_segment_apps_end()[i] ).
+       */
+
+      const std::pmr::vector<uint32_t>&
+      get_segment_apps_begin() const
+      {
+        return m_seg_apps_begin;
+      }
+
+      const std::pmr::vector<uint32_t>&
+      get_segment_apps_end() const
+      {
+        return m_seg_apps_end;
+      }
+
+      /// Get enabled flag by segment index (a segment is enabled, if it and all its parents are not disabled).
+
+      const std::pmr::vector<uint8_t>&
+      get_segment_enabled() const
+      {
+        return m_seg_enabled;
+      }
+
+      /// Get templated flag by segment index.
+
+      const std::pmr::vector<uint8_t>&
+      get_segment_templated() const
+      {
+        return m_seg_templated;
+      }
+
+      /// Get number of applications.
+
+      uint32_t
+      get_num_of_applications() const
+      {
+        return m_apps.size();
+      }
+
+      /// Get generated application objects by application index.
+
+      const std::pmr::vector<const BaseApplication *>&
+      get_applications() const
+      {
+        return m_apps;
+      }
+
+      /// Get segment index by application index.
+
+      const std::pmr::vector<uint32_t>&
+      get_application_segments() const
+      {
+        return m_app_segment;
+      }
+
+      /// Get host index by application index.
+
+      const std::pmr::vector<uint32_t>&
+      get_application_hosts() const
+      {
+        return m_app_host;
+      }
+
+      /// Get class index by application index.
+
+      const std::pmr::vector<uint32_t>&
+      get_application_classes() const
+      {
+        return m_app_class;
+      }
+
+      /// Get role of application in the segment by application index.
+
+      const std::pmr::vector<uint8_t>&
+      get_application_roles() const
+      {
+        return m_app_role;
+      }
+
+      /// Get category of application by application index (see get_category()).
+
+      const std::pmr::vector<uint8_t>&
+      get_application_categories() const
+      {
+        return m_app_category;
+      }
+
+      /// Get hosts by host index.
+
+      const std::pmr::vector<const Computer *>&
+      get_hosts() const
+      {
+        return m_hosts;
+      }
+
+      /// Get masks of categories of applications running on host by host index.
+
+      const std::pmr::vector<CategoryMask>&
+      get_host_categories() const
+      {
+        return m_host_categories;
+      }
+
+      /// Get names of application classes by class index.
+
+      const std::pmr::vector<const std::string *>&
+      get_class_names() const
+      {
+        return m_class_names;
+      }
+
+      /**
+       *  Select applications of segment subtree using optional selection criteria.
+       *  The parameters have the same meaning as for dunedaq::dal::Segment::get_all_applications() algorithm,
+       *  except the \e app_types, which has to contain names of all classes including subclasses.
+       *
+       *  \param out           output vector
+       *  \param seg_idx       index of the segment
+       *  \param app_types     if not null, select applications of given classes
+       *  \param use_segments  if not null, select applications of given segments
+       *  \param use_hosts     if not null, select applications running on given hosts
+       */
+
+      void
+      select(std::vector<const BaseApplication *>& out, uint32_t seg_idx, const std::set<std::string> * app_types, const std::set<std::string> * use_segments, const std::set<const Computer *> * use_hosts) const;
+
+      /**
+       *  Select hosts running at least one application of given categories.
+       *  The hosts are returned in order of their first use by the applications of given categories
+       *  (i.e. in order of Partition::get_all_applications() result ignoring applications of other categories).
+       *
+       *  \param out         output vector
+       *  \param categories  mask of categories
+       */
+
+      void
+      select_hosts(std::vector<const Computer *>& out, CategoryMask categories) const;
+
+      /**
+       *  Select hosts for several masks of categories at once by single pass over the hosts.
+       *  The hosts are ordered as above.
+       *
+       *  \param out         output vectors, one per mask
+       *  \param categories  masks of categories
+       */
+
+      void
+      select_hosts(std::vector<std::vector<const Computer *>>& out, const std::vector<CategoryMask>& categories) const;
+
+
+    private:
+
+      /// index of first application of given categories running on host or npos
+      uint32_t
+      get_first_application(uint32_t host_idx, CategoryMask categories) const;
+
+      // segments
+      std::pmr::vector<const Segment *> m_segments;
+      std::pmr::vector<uint32_t> m_seg_parent;
+      std::pmr::vector<uint32_t> m_seg_children_idx;
+      std::pmr::vector<uint32_t> m_seg_children;
+      std::pmr::vector<uint32_t> m_seg_apps_begin;
+      std::pmr::vector<uint32_t> m_seg_apps_end;
+      std::pmr::vector<uint8_t> m_seg_enabled;
+      std::pmr::vector<uint8_t> m_seg_templated;
+
+      // applications
+      std::pmr::vector<const BaseApplication *> m_apps;
+      std::pmr::vector<uint32_t> m_app_segment;
+      std::pmr::vector<uint32_t> m_app_host;
+      std::pmr::vector<uint32_t> m_app_class;
+      std::pmr::vector<uint8_t> m_app_role;
+      std::pmr::vector<uint8_t> m_app_category;
+
+      // dictionaries
+      std::pmr::vector<const Computer *> m_hosts;
+      std::pmr::vector<CategoryMask> m_host_categories;
+      std::pmr::vector<uint32_t> m_host_first_app;    // index of first application per host and category (host index * num_of_categories + category)
+      std::pmr::vector<const std::string *> m_class_names;
+
+    };
+} // namespace dunedaq::dal
+
+#endif
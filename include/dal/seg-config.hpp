@@ -6,6 +6,7 @@
 
 #include "dal/Segment.hpp"
 #include "dal/app-config.hpp"
+#include "dal/partition-image.hpp"
 
 
 namespace dunedaq::dal {
@@ -64,6 +65,15 @@ namespace dunedaq::dal {
      *  Only enabled (i.e. switched "On") hosts are described.
      *  The first enabled host is considered as "infrastructure" or "default" host.
      *  It is used to run applications without explicitly defined "runs on" relationship.
+     *
+     *  \par Memory
+     *
+     *  The SegConfig objects are allocated from the arena of the segments tree generation owned by the partition
+     *  (see dunedaq::dal::ApplicationConfig). They are released at once, when the configuration is changed and
+     *  the tree has to be regenerated. Their vectors use the default allocator, so the public Segment getters
+     *  keep returning std::vector references.
+     *  After generation the tree is also compiled into read-only dunedaq::dal::PartitionImage;
+     *  the index of the segment in the image is stored by the SegConfig object.
      **/
 
     class SegConfig
@@ -80,7 +90,7 @@ namespace dunedaq::dal {
        */
 
       SegConfig(const Partition * p) :
-          m_partition(p), m_base_segment(nullptr), m_controller(nullptr), m_is_disabled(true), m_is_templated(false)
+          m_partition(p), m_base_segment(nullptr), m_controller(nullptr), m_image_idx(PartitionImage::npos), m_action_timeout(0), m_short_action_timeout(0), m_is_disabled(true), m_is_templated(false)
       {
         ;
       }
@@ -182,6 +192,17 @@ namespace dunedaq::dal {
         return m_is_templated;
       }
 
+      /**
+       *  Get index of the segment in the image of the tree (see dunedaq::dal::Partition::get_image()).
+       *  \return the index or dunedaq::dal::PartitionImage::npos, if the image is not built yet
+       */
+
+      uint32_t
+      get_image_idx() const
+      {
+        return m_image_idx;
+      }
+
 
     private:
 
@@ -192,23 +213,12 @@ namespace dunedaq::dal {
       std::vector<const BaseApplication *> m_applications;
       std::vector<const Segment *> m_nested_segments;
       std::vector<const dunedaq::dal::Computer *> m_hosts;
+      uint32_t m_image_idx;
+      int m_action_timeout;        // computed for all segments by first Segment::get_timeouts() call
+      int m_short_action_timeout;
       bool m_is_disabled;
       bool m_is_templated;
 
-      void
-      clear(const Partition * p)
-      {
-        m_partition = p;
-        m_base_segment = nullptr;
-        m_controller = nullptr;
-        m_infrastructure.clear();
-        m_applications.clear();
-        m_nested_segments.clear();
-        m_hosts.clear();
-        m_is_disabled = false;
-        m_is_templated = false;
-      }
-
     };
 } // namespace dunedaq::dal
 
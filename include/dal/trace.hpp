@@ -0,0 +1,114 @@
+#ifndef _dal_trace_H_
+#define _dal_trace_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace dunedaq::dal {
+
+    /**
+     * \brief The class records spans of the DAL algorithms in Chrome trace-event format
+     *
+     *  The tracing is enabled, when the DAL_TRACE_FILE process environment variable is set to a local file name.
+     *  In such case the algorithms entry points (segments tree generation, get_info() of application,
+     *  disabled components calculation, etc.) record complete events ("ph":"X") into per-thread buffers;
+     *  the buffers are written as JSON array into the file at process exit or when flush() is called explicitly.
+     *  The file can be opened by chrome://tracing or by https://ui.perfetto.dev.
+     *
+     *  When the variable is not set, the cost of a span is a check of a boolean flag.
+     *
+     *  \par Example
+     *
+     *  <pre><i>
+     *
+     *  DAL_TRACE_FILE=/tmp/dal.json dal_dump_apps_mt -d oksconfig:my.data.xml -p my_partition -t 1 4
+     *
+     *  </i></pre>
+     **/
+
+    class Trace
+    {
+
+    public:
+
+      /// Return true, if tracing is enabled by the DAL_TRACE_FILE environment variable.
+
+      static bool
+      is_enabled()
+      {
+        return s_enabled;
+      }
+
+      /// Write recorded events into the trace file; the events of all threads are kept and will be written again by the next flush.
+
+      static void
+      flush();
+
+      /// Record complete event; the times are in nanoseconds since the tracer start.
+
+      static void
+      add(const char * name, const std::string& id, uint64_t start, uint64_t duration);
+
+      /// Get time in nanoseconds since the tracer start.
+
+      static uint64_t
+      now();
+
+
+      /// Record span of the scope; the id is usually identity of processed object (e.g. segment or application).
+
+      class Span
+      {
+
+      public:
+
+        Span(const char * name) :
+          m_name(s_enabled ? name : nullptr),
+          m_id(nullptr)
+        {
+          if (m_name)
+            m_start = now();
+        }
+
+        Span(const char * name, const std::string& id) :
+          m_name(s_enabled ? name : nullptr),
+          m_id(&id)
+        {
+          if (m_name)
+            m_start = now();
+        }
+
+        ~Span()
+        {
+          if (m_name)
+            add(m_name, m_id ? *m_id : s_empty, m_start, now() - m_start);
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+      private:
+
+        const char * m_name;
+        const std::string * m_id;
+        uint64_t m_start;
+
+      };
+
+
+    private:
+
+      static const bool s_enabled;
+      static const std::string s_empty;
+
+    };
+
+} // namespace dunedaq::dal
+
+
+#define DAL_TRACE_JOIN2(A, B) A ## B
+#define DAL_TRACE_JOIN(A, B) DAL_TRACE_JOIN2(A, B)
+#define DAL_TRACE_SPAN(...) ::dunedaq::dal::Trace::Span DAL_TRACE_JOIN(__dal_trace_span_, __LINE__)(__VA_ARGS__)
+
+#endif
@@ -48,10 +48,15 @@ namespace dal {
      *  substitution value. The substitution values are defined either by the
      *  substitution map, or by the process environment.
      *
+     *  \note Without conversion map the values are read from dunedaq::dal::EnvironmentSource::get(), which %is
+     *  by default a snapshot of the process environment taken on first use, not from getenv() on each call.
+     *  The variables changed by setenv() or unsetenv() after the snapshot was taken are not seen, until
+     *  a new snapshot %is set by dunedaq::dal::EnvironmentSource::set_default(dunedaq::dal::EnvironmentSource::snapshot()).
+     *
      *  \par Parameters and return value
      *
      *  \param value            string containing variables to be substituted
-     *  \param conversion_map   pointer to conversion map; if null, the process environment %is used
+     *  \param conversion_map   pointer to conversion map; if null, the process environment %is used (see dunedaq::dal::EnvironmentSource::get())
      *  \param beginning        definition of syntax symbols which delimit the beginning of the variable
      *  \param ending           definition of syntax symbols which delimit the ending of the variable
      *  \return                 Returns the result of substitution.
@@ -167,6 +172,7 @@ namespace dal {
      *
      *  The algorithm %is searching the sw repositories used by given partition,
      *  checking all active segments and applications.
+     *  The result %is cached by the partition until the configuration is reloaded or changed.
      *
      *  The method throws dunedaq::dal::AlgorithmError exception in case of logical problems found in database
      *  (such as circular dependencies between segments, resources or repositories).
@@ -186,6 +192,7 @@ namespace dal {
      *  The function iterates all SW objects of given repository and tests found JarFile objects.
      *  For each JarFile it checks if corresponding JAR file exists in repository root, patch or installation areas.
      *  First readable jar file is added to the class path.
+     *  The existence of files is tested using cached directory listings (see dunedaq::dal::FileSystemProbe).
      *
      *  @param[in] rep               the repository with JarFile objects
      *  @param[in] repository_root   the partition's repository root
@@ -428,6 +435,15 @@ namespace dal {
     ((std::string)objects)
   )
 
+  ERS_DECLARE_ISSUE_BASE(
+    dal,
+    FoundDependencyCycle,
+    AlgorithmError,
+    "Found circular dependency between objects: " << cycle,
+    ,
+    ((std::string)cycle)
+  )
+
   ERS_DECLARE_ISSUE_BASE(
     dal,
     NoJarFile,
@@ -441,6 +457,16 @@ namespace dal {
     ((std::string)rep_class)
   )
 
+  ERS_DECLARE_ISSUE_BASE(
+    dal,
+    NoProgramFile,
+    AlgorithmError,
+    "Cannot find file of program \'" << prog_id << "\' (tried " << candidates << ')',
+    ,
+    ((std::string)prog_id)
+    ((std::string)candidates)
+  )
+
   ERS_DECLARE_ISSUE_BASE(
     dal,
     DuplicatedApplicationID,
@@ -462,6 +488,46 @@ namespace dal {
     ((std::string)second)
   )
 
+  ERS_DECLARE_ISSUE_BASE(
+    dal,
+    BadLaunchPlan,
+    AlgorithmError,
+    "Cannot use launch plan file \'" << file << "\': " << reason,
+    ,
+    ((std::string)file)
+    ((std::string)reason)
+  )
+
+  ERS_DECLARE_ISSUE_BASE(
+    dal,
+    BadAppInfoCache,
+    AlgorithmError,
+    "Cannot use application info cache directory \'" << dir << "\': " << reason,
+    ,
+    ((std::string)dir)
+    ((std::string)reason)
+  )
+
+  ERS_DECLARE_ISSUE_BASE(
+    dal,
+    BadTraceFile,
+    AlgorithmError,
+    "Cannot write trace file \'" << file << "\': " << reason,
+    ,
+    ((std::string)file)
+    ((std::string)reason)
+  )
+
+  ERS_DECLARE_ISSUE_BASE(
+    dal,
+    BadLibraryView,
+    AlgorithmError,
+    "Cannot create shared libraries view directory \'" << dir << "\': " << reason,
+    ,
+    ((std::string)dir)
+    ((std::string)reason)
+  )
+
 } // namespace dunedaq
 
 #endif
@@ -0,0 +1,79 @@
+#ifndef _dal_variables_cache_H_
+#define _dal_variables_cache_H_
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::dal {
+
+    class Tag;
+    class Variable;
+    class VariableSet;
+
+    /**
+     *  The cache of process environment variables values used by the application get_info() algorithm.
+     *
+     *  For each Variable the values are kept per Tag object; for each VariableSet the flattened
+     *  list of names and values of all nested variables is kept per Tag object, so the sets are not
+     *  walked recursively and the multi-value variables are not resolved again for every application.
+     *
+     *  The cache is owned by the partition's ApplicationConfig and is cleared, when the database is
+     *  (re)loaded or changed. The methods can be called by several threads; the returned values are
+     *  shared with the cache, so they stay valid for the caller when the cache is cleared by another thread.
+     */
+
+    class VariablesCache
+    {
+
+    public:
+
+      /// Names and values of variables in the order they are found by recursive walk over the set.
+
+      typedef std::vector<std::pair<std::string, std::string>> Variables;
+
+
+      /// Get value of variable for given tag (see Variable::get_value()); \throw dunedaq::dal::BadVariableUsage
+
+      std::shared_ptr<const std::string>
+      get_value(const dunedaq::dal::Variable& var, const dunedaq::dal::Tag * tag);
+
+      /// Get names and values of variables of the set and its nested sets for given tag; \throw dunedaq::dal::BadVariableUsage
+
+      std::shared_ptr<const Variables>
+      get_variables(const dunedaq::dal::VariableSet& set, const dunedaq::dal::Tag * tag);
+
+      void
+      clear() noexcept;
+
+
+    private:
+
+      /// Small flat map keyed by tag identity; the values are shared with callers.
+
+      template<class T>
+        using TagMap = std::vector<std::pair<const dunedaq::dal::Tag *, std::shared_ptr<const T>>>;
+
+      template<class T>
+        static std::shared_ptr<const T>
+        find(const TagMap<T>& map, const dunedaq::dal::Tag * tag)
+        {
+          for (const auto& x : map)
+            if (x.first == tag)
+              return x.second;
+
+          return nullptr;
+        }
+
+      std::shared_mutex m_mutex;
+      std::unordered_map<const dunedaq::dal::Variable *, TagMap<std::string>> m_values;
+      std::unordered_map<const dunedaq::dal::VariableSet *, TagMap<Variables>> m_sets;
+
+    };
+
+} // namespace dunedaq::dal
+
+#endif
@@ -32,6 +32,7 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <tuple>
 #include <variant>
 #include <vector>
 
@@ -44,6 +45,11 @@ namespace dunedaq::dal::python {
   using AppInfo_t = std::variant<std::string, std::vector<std::string>, std::map<std::string, std::string>>;
   using ComputerProgramInfo_t = std::variant<std::vector<std::string>, std::map<std::string, std::string>>;
 
+  // id, class name, base application id, host id, backup host ids, segment id, is templated,
+  // tag id, program names, environment, start args, restart args, error (empty, if launch info was calculated)
+  using ApplicationRecord_t = std::tuple<std::string, std::string, std::string, std::string, std::vector<std::string>, std::string, bool,
+                                         std::string, std::vector<std::string>, std::map<std::string, std::string>, std::string, std::string, std::string>;
+
   struct ObjectLocator {
     
     ObjectLocator(const std::string& id_arg, const std::string& class_name_arg) :
@@ -221,7 +227,8 @@ namespace dunedaq::dal::python {
 
   private:
 
-    static std::vector<AppConfigHelper> app_translator(const std::vector<const dunedaq::dal::BaseApplication *>& apps_in) {
+    template<class T>
+    static std::vector<AppConfigHelper> app_translator(const T& apps_in) {
       std::vector<AppConfigHelper> apps_out;
 
       for (const auto& app : apps_in) {
@@ -259,6 +266,79 @@ namespace dunedaq::dal::python {
       return apps;
     }
 
+    // the bulk functions are called without the GIL; the results are converted to Python objects after return
+
+    std::vector<ApplicationRecord_t>
+    partition_get_all_applications_info(const Configuration& db,
+                                        const std::string& partition_name,
+                                        std::set<std::string> app_types,
+                                        std::set<std::string> use_segments,
+                                        std::set<std::string> use_hosts,
+                                        bool launch_info) {
+      const dunedaq::dal::Partition* partition = dunedaq::dal::get_partition(const_cast<Configuration&>(db), partition_name);
+
+      check_ptrs({partition});
+
+      std::set<const dunedaq::dal::Computer *> use_hosts_concrete;
+      for (const auto& hostname : use_hosts) {
+	auto computer_ptr = const_cast<Configuration&>(db).get<dunedaq::dal::Computer>(hostname);
+	check_ptrs({computer_ptr});
+	use_hosts_concrete.insert(computer_ptr);
+      }
+
+      const std::vector<const dunedaq::dal::BaseApplication *> apps = partition->get_all_applications(&app_types, &use_segments, &use_hosts_concrete);
+
+      std::vector<ApplicationRecord_t> records;
+      records.reserve(apps.size());
+
+      for (const auto& app : apps) {
+	check_ptrs({app});
+
+	ApplicationRecord_t& r = records.emplace_back();
+
+	std::get<0>(r) = app->UID();
+	std::get<1>(r) = app->class_name();
+	std::get<2>(r) = app->get_base_app()->UID();
+
+	if (const dunedaq::dal::Computer * host = app->get_host())
+	  std::get<3>(r) = host->UID();
+
+	for (const auto& host : app->get_backup_hosts())
+	  std::get<4>(r).push_back(host->UID());
+
+	std::get<5>(r) = app->get_segment()->UID();
+	std::get<6>(r) = app->is_templated();
+
+	if (launch_info) {
+	  try {
+	    if (const dunedaq::dal::Tag * tag = app->get_info(std::get<9>(r), std::get<8>(r), std::get<10>(r), std::get<11>(r)))
+	      std::get<7>(r) = tag->UID();
+	  }
+	  catch (const ers::Issue& ex) {
+	    std::get<12>(r) = ex.what();
+	  }
+	}
+      }
+
+      return records;
+    }
+
+  std::vector<bool> components_disabled(const Configuration& db, const std::string& partition_id, const std::vector<std::string>& component_ids) {
+    const dunedaq::dal::Partition* partition_ptr = const_cast<Configuration&>(db).get<dunedaq::dal::Partition>(partition_id);
+    check_ptrs({partition_ptr});
+
+    std::vector<bool> result;
+    result.reserve(component_ids.size());
+
+    for (const auto& id : component_ids) {
+      const dunedaq::dal::Component* component_ptr = const_cast<Configuration&>(db).get<dunedaq::dal::Component>(id);
+      check_ptrs({component_ptr});
+      result.push_back(component_ptr->disabled(*partition_ptr));
+    }
+
+    return result;
+  }
+
   std::vector<std::vector<ObjectLocator>> component_get_parents(const Configuration& db, const std::string& partition_id, const std::string& component_id) {
     const dunedaq::dal::Component* component_ptr = const_cast<Configuration&>(db).get<dunedaq::dal::Component>(component_id);
     const dunedaq::dal::Partition* partition_ptr = const_cast<Configuration&>(db).get<dunedaq::dal::Partition>(partition_id);
@@ -374,11 +454,14 @@ register_dal_classes(py::module& m)
     ;
 
   m.def("partition_get_all_applications", &partition_get_all_applications, "Get list of applications in the requested partition");
+  m.def("partition_get_all_applications_info", &partition_get_all_applications_info, py::call_guard<py::gil_scoped_release>(),
+        "Get tuples (id, class_name, base_app_id, host_id, backup_host_ids, segment_id, is_templated, tag_id, program_names, environment, start_args, restart_args, error) for all applications in the requested partition");
   m.def("partition_get_log_directory", partition_get_log_directory);
   m.def("partition_get_segment", partition_get_segment);
 
   m.def("component_get_parents", &component_get_parents, "Get the Component-derived class instances of the parent(s) of the Component-derived object in question");
   m.def("component_disabled", &component_disabled, "Determine if a Component-derived object (e.g. a Segment) has been disabled");
+  m.def("components_disabled", &components_disabled, py::call_guard<py::gil_scoped_release>(), "Determine if each of Component-derived objects has been disabled");
 
   m.def("variable_get_value", &variable_get_value, "Get the value stored in an object of class Variable");
 
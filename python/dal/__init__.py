@@ -24,6 +24,12 @@ def setify(arg):
 def _partition_get_all_applications_wrapper(self, db, app_types, use_segments, use_hosts):
     return partition_get_all_applications(db._obj, self.id, setify(app_types), setify(use_segments), setify(use_hosts))
 
+_application_info_fields = ('id', 'class_name', 'base_app_id', 'host', 'backup_hosts', 'segment', 'is_templated',
+                            'tag', 'program_names', 'environment', 'start_args', 'restart_args', 'error')
+
+def _partition_get_all_applications_info_wrapper(self, db, app_types=None, use_segments=None, use_hosts=None, launch_info=True):
+    return [dict(zip(_application_info_fields, a)) for a in partition_get_all_applications_info(db._obj, self.id, setify(app_types), setify(use_segments), setify(use_hosts), launch_info)]
+
 def _partition_get_log_directory_wrapper(self, db):
     return partition_get_log_directory(db._obj, self.id)
 
@@ -45,10 +51,15 @@ def _component_get_parents_wrapper(self, db, partition):
 def _component_disabled_wrapper(self, db, partition):
     return component_disabled(db._obj, partition, self.id)
 
+def _partition_components_disabled_wrapper(self, db, component_ids):
+    return components_disabled(db._obj, self.id, list(component_ids))
+
 def _variable_get_value_wrapper(self, db, tag):
     return variable_get_value(db._obj, self.id, tag.id)
 
 Partition.get_all_applications = _partition_get_all_applications_wrapper
+Partition.get_all_applications_info = _partition_get_all_applications_info_wrapper
+Partition.components_disabled = _partition_components_disabled_wrapper
 Partition.get_log_directory = _partition_get_log_directory_wrapper
 Partition.get_segment = _partition_get_segment_wrapper
 
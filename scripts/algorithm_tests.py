@@ -211,6 +211,70 @@ def get_value_test_case():
     return (res1 == res2) 
 
 
+def get_all_applications_info_test_case():
+
+    apps = partition.get_all_applications(db, None, None, None)
+    records = partition.get_all_applications_info(db)
+    print("Number of applications to be tested : " + str(len(apps)))
+
+    res1 = ""
+    for r in records :
+        res1 += str([r['id'], r['class_name'], r['base_app_id'], r['host'], r['backup_hosts'], r['segment'], r['is_templated']])
+        if r['error'] :
+            res1 += "error"
+        else :
+            res1 += str([r['tag'], sorted(r['environment'].items()), r['program_names'], r['start_args'], r['restart_args']])
+        res1 +='\n'
+
+    res2 = ""
+    for a in apps :
+        res2 += str([a.get_app_id(), a.get_base_app().class_name, a.get_base_app().id, a.get_host().id, [h.id for h in a.get_backup_hosts()], a.get_seg_id(), a.is_templated()])
+        try :
+            info = a.get_info()
+            res2 += str([info['tag'], sorted(info['environment'].items()), info['programNames'], info['startArgs'], info['restartArgs']])
+        except Exception :
+            res2 += "error"
+        res2 +='\n'
+
+    print_output(res1, res2)
+
+    return (res1 == res2)
+
+def components_disabled_test_case():
+
+    components = db.get_dals('Component')
+    print("Number of components to be tested : " + str(len(components)))
+
+    res1 = str(partition.components_disabled(db, [c.id for c in components]))
+    res2 = str([c.disabled(db, partition.id) for c in components])
+
+    print_output(res1, res2)
+
+    return (res1 == res2)
+
+def computer_program_get_info_test_case():
+
+    # program names have to be the same as ones of the application using the program
+    # with the same tag and host; the program environment is a part of application one
+
+    res1 = ""
+    res2 = ""
+    records = [r for r in partition.get_all_applications_info(db) if not r['error']]
+    print("Number of programs to be tested : " + str(len(records)))
+
+    for r in records :
+        program = db.get_dal(r['class_name'], r['base_app_id']).Program
+        info = dal.computer_program_get_info(db._obj, partition.id, program.id, r['tag'], r['host'])
+        environment = info[0]
+        program_names = info[1]
+
+        res1 += str([r['id'], program_names, sorted(environment.keys())]) + '\n'
+        res2 += str([r['id'], r['program_names'], sorted(k for k in environment.keys() if k in r['environment'])]) + '\n'
+
+    print_output(res1, res2)
+
+    return (res1 == res2)
+
 
 if __name__ == '__main__':
     global db
@@ -245,6 +309,15 @@ if __name__ == '__main__':
     print(f"\n\nRUNNING TEST \"get_timeouts_test_case\"")
     check( get_timeouts_test_case(), "get_timeouts_test_case")
 
+    print(f"\n\nRUNNING TEST \"get_all_applications_info_test_case\"")
+    check( get_all_applications_info_test_case(), "get_all_applications_info_test_case")
+
+    print(f"\n\nRUNNING TEST \"components_disabled_test_case\"")
+    check( components_disabled_test_case(), "components_disabled_test_case")
+
+    print(f"\n\nRUNNING TEST \"computer_program_get_info_test_case\"")
+    check( computer_program_get_info_test_case(), "computer_program_get_info_test_case")
+
     print("""
 n.b. newlines have been removed from the test output above; the important 
 thing is that the output agrees between calls to the C++ function and their
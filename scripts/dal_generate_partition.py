@@ -0,0 +1,310 @@
+#!/usr/bin/env python
+
+# Generate synthetic OKS partition of chosen size to measure scalability of the DAL algorithms.
+#
+# The partition contains:
+#  - normal segments with nested segments, run control and custom lifetime applications;
+#  - template segments with racks of hosts, template controller, infrastructure and applications;
+#  - resource sets of chosen depth and width in every segment, some resources are disabled;
+#  - software repositories forming DAG of chosen depth and width, used by binaries;
+#  - partition parameters referencing each other and used by process environment.
+#
+# Use dal_benchmark to run the algorithms on generated partition.
+
+import argparse
+import sys
+from argparse import RawTextHelpFormatter
+
+from xml.sax.saxutils import quoteattr
+
+
+prologue = '''<?xml version="1.0" encoding="ASCII"?>
+
+<!-- oks-data version 2.2 -->
+
+
+<!DOCTYPE oks-data [
+  <!ELEMENT oks-data (info, (include)?, (comments)?, (obj)+)>
+  <!ELEMENT info EMPTY>
+  <!ATTLIST info
+      name CDATA #IMPLIED
+      type CDATA #IMPLIED
+      num-of-items CDATA #REQUIRED
+      oks-format CDATA #FIXED "data"
+      oks-version CDATA #REQUIRED
+      created-by CDATA #IMPLIED
+      created-on CDATA #IMPLIED
+      creation-time CDATA #IMPLIED
+      last-modified-by CDATA #IMPLIED
+      last-modified-on CDATA #IMPLIED
+      last-modification-time CDATA #IMPLIED
+  >
+  <!ELEMENT include (file)*>
+  <!ELEMENT file EMPTY>
+  <!ATTLIST file
+      path CDATA #REQUIRED
+  >
+  <!ELEMENT comments (comment)*>
+  <!ELEMENT comment EMPTY>
+  <!ATTLIST comment
+      creation-time CDATA #REQUIRED
+      created-by CDATA #REQUIRED
+      created-on CDATA #REQUIRED
+      author CDATA #REQUIRED
+      text CDATA #REQUIRED
+  >
+  <!ELEMENT obj (attr | rel)*>
+  <!ATTLIST obj
+      class CDATA #REQUIRED
+      id CDATA #REQUIRED
+  >
+  <!ELEMENT attr (data)*>
+  <!ATTLIST attr
+      name CDATA #REQUIRED
+      type (bool|s8|u8|s16|u16|s32|u32|s64|u64|float|double|date|time|string|uid|enum|class|-) "-"
+      val CDATA ""
+  >
+  <!ELEMENT data EMPTY>
+  <!ATTLIST data
+      val CDATA #REQUIRED
+  >
+  <!ELEMENT rel (ref)*>
+  <!ATTLIST rel
+      name CDATA #REQUIRED
+      class CDATA ""
+      id CDATA ""
+  >
+  <!ELEMENT ref EMPTY>
+  <!ATTLIST ref
+      class CDATA #REQUIRED
+      id CDATA #REQUIRED
+  >
+]>
+
+<oks-data>
+'''
+
+hw_tag = 'x86_64-centos7'
+sw_tag = 'gcc8-opt'
+
+
+class Obj:
+    def __init__(self, class_name, uid):
+        self.class_name = class_name
+        self.uid = uid
+        self.attrs = []
+        self.rels = []
+
+    def attr(self, name, type, value):
+        self.attrs.append((name, type, value))
+        return self
+
+    def rel(self, name, value):
+        self.rels.append((name, value))
+        return self
+
+    def write(self, out):
+        out.write('\n<obj class=%s id=%s>\n' % (quoteattr(self.class_name), quoteattr(self.uid)))
+        for (name, type, value) in self.attrs:
+            out.write(' <attr name=%s type="%s" val=%s/>\n' % (quoteattr(name), type, quoteattr(str(value))))
+        for (name, value) in self.rels:
+            if isinstance(value, list):
+                out.write(' <rel name=%s>\n' % quoteattr(name))
+                for x in value:
+                    out.write('  <ref class=%s id=%s/>\n' % (quoteattr(x.class_name), quoteattr(x.uid)))
+                out.write(' </rel>\n')
+            else:
+                out.write(' <rel name=%s class=%s id=%s/>\n' % (quoteattr(name), quoteattr(value.class_name), quoteattr(value.uid)))
+        out.write('</obj>\n')
+
+
+class Generator:
+    def __init__(self, args):
+        self.args = args
+        self.objs = []
+        self.disabled = []
+        self.num_of_leaves = 0
+
+    def add(self, class_name, uid):
+        o = Obj(class_name, uid)
+        self.objs.append(o)
+        return o
+
+    def host(self, idx):
+        return self.hosts[idx % len(self.hosts)]
+
+    def gen_software(self):
+        a = self.args
+        self.tag = self.add('Tag', 'gen-tag').attr('HW_Tag', 'enum', hw_tag).attr('SW_Tag', 'enum', sw_tag)
+
+        # partition parameters: each references previous one
+
+        self.params = []
+        for i in range(a.parameters):
+            value = 'value-%d' % i if i == 0 else 'value-%d:${GEN_PARAM_%d}' % (i, i - 1)
+            self.params.append(self.add('Variable', 'gen-param-%d' % i).attr('Name', 'string', 'GEN_PARAM_%d' % i).attr('Value', 'string', value))
+
+        self.param_set = None
+        if self.params:
+            self.param_set = self.add('VariableSet', 'gen-params').rel('Contains', self.params)
+
+        # repositories DAG: each repository uses two repositories of next level
+
+        levels = []
+        for l in range(a.repository_depth):
+            level = []
+            for i in range(a.repository_width):
+                uid = 'gen-repo-%d-%d' % (l, i)
+                env = self.add('Variable', uid + '-env').attr('Name', 'string', 'GEN_REPO_%d_%d' % (l, i)).attr('Value', 'string', '${GEN_PARAM_%d}' % ((l * a.repository_width + i) % a.parameters) if a.parameters else 'none')
+                r = self.add('SW_Repository', uid).attr('Name', 'string', uid).attr('InstallationPath', 'string', '/sw/' + uid).attr('InstallationPathVariableName', 'string', 'GEN_REPO_%d_%d_INST_PATH' % (l, i))
+                r.rel('Tags', [self.tag]).rel('ProcessEnvironment', [env])
+                level.append(r)
+            levels.append(level)
+
+        for l in range(len(levels) - 1):
+            for i, r in enumerate(levels[l]):
+                uses = [levels[l + 1][i]]
+                if a.repository_width > 1:
+                    uses.append(levels[l + 1][(i + 1) % a.repository_width])
+                r.rel('Uses', uses)
+
+        self.repositories = levels[0]
+
+        def binary(uid, idx):
+            repo = self.repositories[idx % len(self.repositories)]
+            return self.add('Binary', uid).attr('BinaryName', 'string', uid).attr('DefaultParameters', 'string', '-n ' + uid).rel('BelongsTo', repo).rel('Uses', [repo])
+
+        self.rc_binary = binary('gen-rc', 0)
+        self.pmg_binary = binary('gen-pmg', 0)
+        self.infra_binary = binary('gen-infra', 1)
+        self.app_binaries = [binary('gen-app-%d' % i, i) for i in range(max(1, a.repository_width))]
+
+    def gen_hosts(self):
+        a = self.args
+        self.hosts = []
+        for i in range(max(1, a.hosts)):
+            self.hosts.append(self.add('Computer', 'gen-host-%d.example.org' % i).attr('HW_Tag', 'enum', hw_tag).attr('Description', 'string', '').attr('State', 'bool', 1).attr('RLogin', 'string', 'ssh'))
+
+    def gen_resources(self, prefix, depth):
+        a = self.args
+        if depth == 0:
+            self.num_of_leaves += 1
+            r = self.add('Resource', prefix)
+            if a.disable_every and self.num_of_leaves % a.disable_every == 0:
+                self.disabled.append(r)
+            return r
+
+        return self.add('ResourceSetAND', prefix).rel('Contains', [self.gen_resources('%s-%d' % (prefix, i), depth - 1) for i in range(a.resource_width)])
+
+    def gen_segment(self, uid, depth, idx):
+        a = self.args
+
+        rc = self.add('RunControlApplication', uid + '-rc').attr('InterfaceName', 'string', 'rc/commander').rel('Program', self.rc_binary).rel('RunsOn', self.host(idx))
+        apps = []
+        for j in range(a.apps_per_segment):
+            apps.append(self.add('CustomLifetimeApplication', '%s-app-%d' % (uid, j)).attr('Lifetime', 'enum', 'Boot_Shutdown').attr('Parameters', 'string', '-i %d ${GEN_PARAM_0}' % j if a.parameters else '-i %d' % j).rel('Program', self.app_binaries[j % len(self.app_binaries)]).rel('RunsOn', self.host(idx + j + 1)).rel('BackupHosts', [self.host(idx + j + 2)]))
+
+        s = self.add('Segment', uid).rel('IsControlledBy', rc).rel('Applications', apps).rel('Hosts', [self.host(idx)])
+
+        if a.resource_depth:
+            s.rel('Resources', [self.gen_resources(uid + '-res', a.resource_depth)])
+
+        if depth > 0:
+            s.rel('Segments', [self.gen_segment('%s-%d' % (uid, i), depth - 1, idx * a.nested_segments + i) for i in range(a.nested_segments)])
+
+        return s
+
+    def gen_template_segment(self, uid, idx):
+        a = self.args
+
+        racks = []
+        for r in range(a.racks):
+            first = (idx * a.racks + r) * a.hosts_per_rack
+            nodes = [self.host(first + i) for i in range(max(2, a.hosts_per_rack))]
+            racks.append(self.add('Rack', '%s-rack-%d' % (uid, r)).attr('Description', 'string', '').rel('Nodes', nodes).rel('LFS', [nodes[0]]))
+
+        rc = self.add('RunControlTemplateApplication', uid + '-rc').attr('InterfaceName', 'string', 'rc/commander').attr('RunsOn', 'enum', 'FirstHost').rel('Program', self.rc_binary)
+        infra = self.add('InfrastructureTemplateApplication', uid + '-infra').attr('RunsOn', 'enum', 'FirstHostWithBackup').rel('Program', self.infra_binary)
+        app = self.add('CustomLifetimeTemplateApplication', uid + '-app').attr('Instances', 'u16', a.template_instances).attr('RunsOn', 'enum', 'AllButFirstHost').rel('Program', self.app_binaries[idx % len(self.app_binaries)])
+
+        return self.add('TemplateSegment', uid).rel('IsControlledBy', rc).rel('Infrastructure', [infra]).rel('Applications', [app]).rel('Racks', racks)
+
+    def generate(self):
+        a = self.args
+
+        self.gen_hosts()
+        self.gen_software()
+
+        segments = [self.gen_segment('gen-seg-%d' % i, a.segment_depth, i) for i in range(a.segments)]
+        segments += [self.gen_template_segment('gen-tseg-%d' % i, i) for i in range(a.template_segments)]
+
+        partition = Obj('Partition', a.partition)
+        online = Obj('OnlineSegment', 'gen-online')
+
+        root_rc = self.add('RunControlApplication', 'gen-root-rc').attr('InterfaceName', 'string', 'rc/commander').rel('Program', self.rc_binary).rel('RunsOn', self.host(0))
+        online_infra = self.add('InfrastructureApplication', 'gen-online-infra').rel('Program', self.infra_binary).rel('RunsOn', self.host(0))
+
+        online.rel('IsControlledBy', root_rc).rel('InitialPartition', partition).rel('PmgAgent', self.pmg_binary).rel('Hosts', [self.host(0)])
+        self.objs.append(online)
+
+        env = [self.add('Variable', 'gen-env-%d' % i).attr('Name', 'string', 'GEN_ENV_%d' % i).attr('Value', 'string', '${GEN_PARAM_%d}' % i) for i in range(min(a.parameters, 16))]
+
+        partition.rel('OnlineInfrastructure', online).rel('OnlineInfrastructureApplications', [online_infra]).rel('DefaultHost', self.host(0)).rel('DefaultTags', [self.tag]).rel('Segments', segments).rel('ProcessEnvironment', env)
+
+        if self.param_set:
+            partition.rel('Parameters', [self.param_set])
+
+        if self.disabled:
+            partition.rel('Disabled', self.disabled)
+
+        self.objs.append(partition)
+
+    def write(self, out):
+        out.write(prologue)
+        out.write('\n<info name="" type="" num-of-items="%d" oks-format="data" oks-version="N/A" created-by="dal_generate_partition" created-on="" creation-time="" last-modified-by="" last-modified-on="" last-modification-time=""/>\n' % len(self.objs))
+        out.write('\n<include>\n <file path=%s/>\n</include>\n' % quoteattr(self.args.schema))
+        for o in self.objs:
+            o.write(out)
+        out.write('\n</oks-data>\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate synthetic partition to measure scalability of DAL algorithms.\n'
+                                                 'Example:\n  dal_generate_partition.py -o big.data.xml --segments 100 --template-segments 20 --racks 4', formatter_class=RawTextHelpFormatter)
+    parser.add_argument('-o', '--output', required=True, help='name of generated OKS data file')
+    parser.add_argument('-p', '--partition', default='gen-partition', help='name of the partition object')
+    parser.add_argument('--schema', default='schema/dal/core.schema.xml', help='path of included core schema file')
+    parser.add_argument('--hosts', type=int, default=64, help='number of hosts')
+    parser.add_argument('--segments', type=int, default=10, help='number of top-level segments')
+    parser.add_argument('--segment-depth', type=int, default=1, help='depth of nested segments of each top-level segment')
+    parser.add_argument('--nested-segments', type=int, default=2, help='number of nested segments of each segment above maximum depth')
+    parser.add_argument('--apps-per-segment', type=int, default=4, help='number of applications of each normal segment')
+    parser.add_argument('--template-segments', type=int, default=2, help='number of template segments')
+    parser.add_argument('--racks', type=int, default=2, help='number of racks of each template segment')
+    parser.add_argument('--hosts-per-rack', type=int, default=4, help='number of hosts of each rack (at least two)')
+    parser.add_argument('--template-instances', type=int, default=1, help='number of instances of template application per host')
+    parser.add_argument('--resource-depth', type=int, default=2, help='depth of resource sets tree of each segment (0 means no resources)')
+    parser.add_argument('--resource-width', type=int, default=2, help='number of children of each resource set')
+    parser.add_argument('--disable-every', type=int, default=7, help='disable every n-th resource (0 means none)')
+    parser.add_argument('--repository-depth', type=int, default=3, help='number of levels of software repositories DAG')
+    parser.add_argument('--repository-width', type=int, default=2, help='number of software repositories on each level of DAG')
+    parser.add_argument('--parameters', type=int, default=16, help='number of partition parameters')
+
+    args = parser.parse_args()
+
+    if args.repository_depth < 1 or args.repository_width < 1:
+        print('ERROR: repository depth and width have to be positive', file=sys.stderr)
+        return 1
+
+    g = Generator(args)
+    g.generate()
+
+    with open(args.output, 'w') as out:
+        g.write(out)
+
+    print('generated %d objects in %s' % (len(g.objs), args.output))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -10,12 +10,19 @@
 
 #include <strings.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include <list>
+#include <memory_resource>
 #include <set>
 #include <iostream>
 #include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
+#include <functional>
+#include <thread>
 
 #include "ers/ers.hpp"
 #include "okssystem/Host.hpp"
@@ -26,14 +33,22 @@
 #include "oksdbinterfaces/ConfigObject.hpp"
 #include "oksdbinterfaces/ConfigAction.hpp"
 #include "oksdbinterfaces/Configuration.hpp"
-#include "oksdbinterfaces/map.hpp"
 
 #include "dal/util.hpp"
+#include "dal/class-mask.hpp"
+#include "dal/environment-source.hpp"
+#include "dal/file-system-probe.hpp"
+#include "dal/instrumentation.hpp"
+#include "dal/launch-options.hpp"
+#include "dal/library-view.hpp"
+#include "dal/trace.hpp"
+#include "dal/variables-cache.hpp"
 
 #include "dal/BinaryFile.hpp"
 #include "dal/Binary.hpp"
 #include "dal/Computer.hpp"
 #include "dal/ComputerSet.hpp"
+#include "dal/CustomLifetimeApplicationBase.hpp"
 #include "dal/InfrastructureApplication.hpp"
 #include "dal/InfrastructureTemplateApplication.hpp"
 #include "dal/JarFile.hpp"
@@ -124,12 +139,12 @@ find_enabled(const std::vector<const dunedaq::dal::ComputerBase *>& hosts);
 static const dunedaq::dal::Computer *
 find_enabled(const dunedaq::dal::ComputerBase * cb)
 {
-  if (const dunedaq::dal::Computer * c = cb->cast<dunedaq::dal::Computer>())
+  if (const dunedaq::dal::Computer * c = dunedaq::dal::ClassMask::cast<dunedaq::dal::Computer>(cb))
     {
       if (c->get_State())
         return c;
     }
-  else if (const dunedaq::dal::ComputerSet * cs = cb->cast<dunedaq::dal::ComputerSet>())
+  else if (const dunedaq::dal::ComputerSet * cs = dunedaq::dal::ClassMask::cast<dunedaq::dal::ComputerSet>(cb))
     {
       for (const auto & i : cs->get_Contains())
         {
@@ -158,11 +173,11 @@ find_enabled(const std::vector<const dunedaq::dal::ComputerBase *>& hosts)
 static void
 add_computers(std::vector<const dunedaq::dal::Computer *>& v, const dunedaq::dal::ComputerBase * cb)
 {
-  if (const dunedaq::dal::Computer * cp = cb->cast<dunedaq::dal::Computer>())
+  if (const dunedaq::dal::Computer * cp = dunedaq::dal::ClassMask::cast<dunedaq::dal::Computer>(cb))
     {
       v.push_back(cp);
     }
-  else if (const dunedaq::dal::ComputerSet * cs = cb->cast<dunedaq::dal::ComputerSet>())
+  else if (const dunedaq::dal::ComputerSet * cs = dunedaq::dal::ClassMask::cast<dunedaq::dal::ComputerSet>(cb))
     {
       for (const auto & i : cs->get_Contains())
         add_computers(v, i);
@@ -207,26 +222,44 @@ dunedaq::dal::Variable::get_value(const Tag * tag) const
    */
 
 static void
-add_env_var(Emap& dict, const dunedaq::dal::Variable * var, const dunedaq::dal::Tag * tag)
+add_env_var(Emap& dict, const dunedaq::dal::Variable * var, const dunedaq::dal::Tag * tag, dunedaq::dal::VariablesCache * cache)
 {
-  dict.emplace(var->get_Name(), var->get_value(tag));
+  if (dict.find(var->get_Name()) == dict.end())
+    dict.emplace(var->get_Name(), cache ? *cache->get_value(*var, tag) : var->get_value(tag));
 }
 
 
   /**
    *  Static function to add a parameter (variable or set) to the map.
+   *  When the cache is provided, the values of variables and the flattened sets are taken from it.
    */
 
 static void
-add_env_vars(Emap& dict, const EnvironmentVars& envs, const dunedaq::dal::Tag * tag)
+add_env_vars(Emap& dict, const EnvironmentVars& envs, const dunedaq::dal::Tag * tag, dunedaq::dal::VariablesCache * cache)
 {
   for (const auto & i : envs)
-    if (const dunedaq::dal::Variable * var = i->cast<dunedaq::dal::Variable>())
-      add_env_var(dict, var, tag);
-    else if (const dunedaq::dal::VariableSet * vars = i->cast<dunedaq::dal::VariableSet>())
-      add_env_vars(dict, vars->get_Contains(), tag);
+    if (const dunedaq::dal::Variable * var = dunedaq::dal::ClassMask::cast<dunedaq::dal::Variable>(i))
+      add_env_var(dict, var, tag, cache);
+    else if (const dunedaq::dal::VariableSet * vars = dunedaq::dal::ClassMask::cast<dunedaq::dal::VariableSet>(i))
+      {
+        if (cache)
+          {
+            const std::shared_ptr<const dunedaq::dal::VariablesCache::Variables> values(cache->get_variables(*vars, tag));
+
+            for (const auto& x : *values)
+              dict.emplace(x.first, x.second);
+          }
+        else
+          add_env_vars(dict, vars->get_Contains(), tag, nullptr);
+      }
 }
 
+static dunedaq::dal::VariablesCache&
+get_variables_cache(const dunedaq::dal::Partition& p);
+
+static std::string
+get_class_path(const dunedaq::dal::Partition& p, const std::vector<const dunedaq::dal::SW_Package*>& packages, const std::string& user_dir);
+
 
   /**
    *  Static function to add special variable to the map.
@@ -328,7 +361,9 @@ get_paths(
     const BinaryInfo& binary_info,
     dunedaq::dal::TestCircularDependency& cd_fuse)
 {
-  if (const dunedaq::dal::SW_Repository * repository = package->cast<dunedaq::dal::SW_Repository>())
+  DAL_INSTRUMENT_SCOPE(GetPaths);
+
+  if (const dunedaq::dal::SW_Repository * repository = dunedaq::dal::ClassMask::cast<dunedaq::dal::SW_Repository>(package))
     {
       const std::string& patch_area(repository->get_PatchArea());
       const std::string& installation_path(repository->get_InstallationPath());
@@ -355,7 +390,7 @@ get_paths(
           add_search_path(paths_to_shared_libraries, make_path(installation_path, binary_info.m_lib_path));
         }
     }
-  else if (const dunedaq::dal::SW_ExternalPackage * epkg = package->cast<dunedaq::dal::SW_ExternalPackage>())
+  else if (const dunedaq::dal::SW_ExternalPackage * epkg = dunedaq::dal::ClassMask::cast<dunedaq::dal::SW_ExternalPackage>(package))
     {
       const std::string& package_patch_area(epkg->get_PatchArea());
       const std::string& package_installation_path(epkg->get_InstallationPath());
@@ -411,14 +446,14 @@ static void
 check_tag(const dunedaq::dal::SW_Package* package, const dunedaq::dal::Tag& tag, dunedaq::dal::TestCircularDependency& cd_fuse)
 // throws (dunedaq::dal::BadTag)
 {
-  if (const dunedaq::dal::SW_Repository * repository = package->cast<dunedaq::dal::SW_Repository>())
+  if (const dunedaq::dal::SW_Repository * repository = dunedaq::dal::ClassMask::cast<dunedaq::dal::SW_Repository>(package))
     {
       // Check through the tags to see if there is a match
       for (const auto& i : repository->get_Tags())
         if (i == &tag)
           goto test_used_sw_packages;
     }
-  else if (const dunedaq::dal::SW_ExternalPackage * epkg = package->cast<dunedaq::dal::SW_ExternalPackage>())
+  else if (const dunedaq::dal::SW_ExternalPackage * epkg = dunedaq::dal::ClassMask::cast<dunedaq::dal::SW_ExternalPackage>(package))
     {
       // Check through the shared library tag mappings to see if there is a match
       for (const auto& i : epkg->get_SharedLibraries())
@@ -495,7 +530,7 @@ make_parents_list(
         {
           add_path(p_list, out);
         }
-      else if (const dunedaq::dal::ResourceSet * rs = i->cast<dunedaq::dal::ResourceSet>())
+      else if (const dunedaq::dal::ResourceSet * rs = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(i))
         {
           make_parents_list(child, rs, p_list, out, cd_fuse);
         }
@@ -533,7 +568,7 @@ make_parents_list(
       for (const auto& i : segment->get_Resources())
         if (i->config_object().implementation() == child)
           add_path(p_list, out);
-        else if (const dunedaq::dal::ResourceSet * resource_set = i->cast<dunedaq::dal::ResourceSet>())
+        else if (const dunedaq::dal::ResourceSet * resource_set = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(i))
           make_parents_list(child, resource_set, p_list, out, cd_fuse);
     }
 
@@ -565,13 +600,16 @@ check_segment(
 void
 dunedaq::dal::Component::get_parents(const dunedaq::dal::Partition& partition, std::list<std::vector<const dunedaq::dal::Component *>>& parents) const
 {
+  DAL_INSTRUMENT_SCOPE(GetParents);
+  DAL_TRACE_SPAN("get_parents", UID());
+
   const ConfigObjectImpl * obj_impl = config_object().implementation();
 
   const bool is_segment = castable(dunedaq::dal::Segment::s_class_name);
 
   try
     {
-      dunedaq::dal::TestCircularDependency cd_fuse("component parents", &partition);
+      dunedaq::dal::TestCircularDependency cd_fuse("component parents", &partition, dunedaq::dal::is_dependency_graph_validated(partition));
 
       // check partition's segments
       for (const auto& i : partition.get_Segments())
@@ -624,6 +662,26 @@ dunedaq::dal::is_compatible(const dunedaq::dal::Tag& tag, const dunedaq::dal::Co
 static void
 set_path(std::map<std::string, std::string>& environment, const std::string& var, std::vector<std::string>& value)
 {
+  // remove non-existent and empty directories, if required
+
+  if (dunedaq::dal::LaunchOptions::is_set(dunedaq::dal::LaunchOptions::PrunePaths))
+    {
+      std::string::size_type len = 0;
+
+      for (const auto& i : value)
+        len += i.size() + 1;
+
+      const std::size_t num = value.size();
+      const std::size_t pruned = dunedaq::dal::FileSystemProbe::remove_empty_directories(value);
+
+      for (const auto& i : value)
+        len -= i.size() + 1;
+
+      dunedaq::dal::LaunchOptions::add_pruned(num, pruned, len);
+
+      TLOG_DEBUG(5) << "prune " << pruned << " of " << num << " directories of " << var;
+    }
+
   // create colon-separated string from tokens
 
   std::string s;
@@ -660,6 +718,70 @@ set_path(std::map<std::string, std::string>& environment, const std::string& var
     }
 }
 
+  // replace shared libraries directories by their view, if required; on failure use the directories
+
+static void
+set_library_path(std::map<std::string, std::string>& environment, std::vector<std::string>& value, const dunedaq::dal::Tag& tag)
+{
+  if (dunedaq::dal::LaunchOptions::is_set(dunedaq::dal::LaunchOptions::LibraryView) && value.size() > 1)
+    {
+      try
+        {
+          std::string view(dunedaq::dal::LibraryView::get(value, tag.UID()));
+          value.clear();
+          value.push_back(std::move(view));
+        }
+      catch (const dunedaq::dal::BadLibraryView& ex)
+        {
+          ers::warning(ex);
+        }
+    }
+
+  set_path(environment, s_ld_library_path_str, value);
+}
+
+  // leave the first executable program file, if required; the candidates are filtered using the cached listings
+  // of directories and only the existing ones are tested to be regular executable files (the launchers use execvp)
+
+static bool
+is_executable_file(const std::string& path)
+{
+  struct stat buf;
+  return (stat(path.c_str(), &buf) == 0 && S_ISREG(buf.st_mode) && access(path.c_str(), X_OK) == 0);
+}
+
+static void
+resolve_program(std::vector<std::string>& program_names, const dunedaq::dal::ComputerProgram& program)
+{
+  if (dunedaq::dal::LaunchOptions::is_set(dunedaq::dal::LaunchOptions::ResolvePrograms) == false)
+    return;
+
+  for (auto& x : program_names)
+    if (dunedaq::dal::FileSystemProbe::exists(x) && is_executable_file(x))
+      {
+        TLOG_DEBUG(5) << "resolve program file of " << &program << ": " << x;
+
+        std::string name(std::move(x));
+        program_names.clear();
+        program_names.push_back(std::move(name));
+        return;
+      }
+
+  std::string candidates;
+
+  for (const auto& x : program_names)
+    {
+      if (!candidates.empty())
+        candidates.append(", ");
+
+      candidates.push_back('\'');
+      candidates.append(x);
+      candidates.push_back('\'');
+    }
+
+  throw dunedaq::dal::NoProgramFile(ERS_HERE, program.UID(), candidates);
+}
+
 
 /***************************************************************************/
 
@@ -704,35 +826,45 @@ get_env(const char * name)
   return val;
 }
 
+  // get non-empty value of variable from environment source used by the algorithms
+
+static const std::string *
+get_env(const dunedaq::dal::EnvironmentSource& source, const std::string& name)
+{
+  const std::string * val = source.find(name);
+  if (val && val->empty())
+    return nullptr;
+  return val;
+}
+
 
   // helper functions to get partition environment
   // note, they cannot be combined together since there is an order of environment build
   // and some code is executed between add_front... and add_end_partition_environment()
 
-static const char * s_repository(get_env(s_tdaq_db_repository_str.c_str()));
-
 static void
 add_front_partition_environment(std::map<std::string, std::string>& environment, const dunedaq::dal::Partition& partition)
 {
-  if (s_repository)
+  const std::shared_ptr<const dunedaq::dal::EnvironmentSource> source(dunedaq::dal::EnvironmentSource::get());
+  const std::string * repository = get_env(*source, s_tdaq_db_repository_str);
+
+  if (repository)
     {
-      if (const char * s_user_repository = get_env(s_tdaq_db_user_repository_str.c_str()))
+      if (const std::string * user_repository = get_env(*source, s_tdaq_db_user_repository_str))
         {
-          add_env_var(environment, s_tdaq_db_path_str, s_user_repository);
-          TLOG_DEBUG(2) <<  "Set " << s_tdaq_db_path_str << "=" << s_user_repository << " and unset " << s_tdaq_db_user_repository_str << " and " << s_tdaq_db_repository_str ;
+          add_env_var(environment, s_tdaq_db_path_str, *user_repository);
+          TLOG_DEBUG(2) <<  "Set " << s_tdaq_db_path_str << "=" << *user_repository << " and unset " << s_tdaq_db_user_repository_str << " and " << s_tdaq_db_repository_str ;
         }
       else
         {
-          static const char * s_mapping_dir(get_env(s_oks_repository_mapping_dir_str.c_str()));
-
-          add_env_var(environment, s_tdaq_db_repository_str, s_repository);
+          add_env_var(environment, s_tdaq_db_repository_str, *repository);
           add_env_var(environment, s_tdaq_db_path_str, "");
-          TLOG_DEBUG(2) <<  "Set " << s_tdaq_db_repository_str << '=' << s_repository << " and unset " << s_tdaq_db_path_str ;
+          TLOG_DEBUG(2) <<  "Set " << s_tdaq_db_repository_str << '=' << *repository << " and unset " << s_tdaq_db_path_str ;
 
-          if (s_mapping_dir)
+          if (const std::string * mapping_dir = get_env(*source, s_oks_repository_mapping_dir_str))
             {
-              add_env_var(environment, s_oks_repository_mapping_dir_str, s_mapping_dir);
-              TLOG_DEBUG(2) <<  "Set " << s_oks_repository_mapping_dir_str << '=' << s_mapping_dir ;
+              add_env_var(environment, s_oks_repository_mapping_dir_str, *mapping_dir);
+              TLOG_DEBUG(2) <<  "Set " << s_oks_repository_mapping_dir_str << '=' << *mapping_dir ;
             }
         }
     }
@@ -745,7 +877,7 @@ add_front_partition_environment(std::map<std::string, std::string>& environment,
       if (!IPCRef.empty())
         add_env_var(environment, s_tdaq_ipc_init_ref_str, IPCRef);
 
-      if (!s_repository)
+      if (!repository)
         { // is taken only is TDAQ_DB_REPOSITORY is not set
           const std::string& DBPath = partition.get_DBPath();
           if (!DBPath.empty())
@@ -797,9 +929,11 @@ add_end_partition_environment(std::map<std::string, std::string>& environment,
                               const dunedaq::dal::Tag * tag)
 {
   // Partition needs Environment
-  add_env_vars(environment, partition.get_ProcessEnvironment(), tag);
+  dunedaq::dal::VariablesCache& cache(get_variables_cache(partition));
 
-  if (s_repository && environment.find(s_tdaq_db_version_str) == environment.end())
+  add_env_vars(environment, partition.get_ProcessEnvironment(), tag, &cache);
+
+  if (get_env(*dunedaq::dal::EnvironmentSource::get(), s_tdaq_db_repository_str) && environment.find(s_tdaq_db_version_str) == environment.end())
     add_env_var(environment, s_tdaq_db_version_str, partition.get_DBVersion());
 
   // Add environment defined by the sw packages used by application (if != 0) and the computer program
@@ -813,10 +947,10 @@ add_end_partition_environment(std::map<std::string, std::string>& environment,
     used_sw.add(computer_program->get_Uses());
 
     for (const auto &i : used_sw.m_packages)
-      add_env_vars(environment, i->get_ProcessEnvironment(), tag);
+      add_env_vars(environment, i->get_ProcessEnvironment(), tag, &cache);
 
     for (const auto &j : used_sw.m_packages)
-      if (const dunedaq::dal::SW_Repository *sr = j->cast<dunedaq::dal::SW_Repository>())
+      if (const dunedaq::dal::SW_Repository *sr = dunedaq::dal::ClassMask::cast<dunedaq::dal::SW_Repository>(j))
         {
           const std::string &rn = sr->get_InstallationPathVariableName();
           if (!rn.empty())
@@ -863,14 +997,13 @@ add_end_partition_environment(std::map<std::string, std::string>& environment,
               TLOG_DEBUG(5) <<  "CLASSPATH defined via environment: " << class_path ;
             }
 
-          const std::string &user_dir(partition.get_RepositoryRoot());
+          const std::string jars(get_class_path(partition, used_sw.m_packages, partition.get_RepositoryRoot()));
 
-          for (const auto &j : used_sw.m_packages)
+          if (!jars.empty())
             {
-              if (const dunedaq::dal::SW_Repository *rep = j->cast<dunedaq::dal::SW_Repository>())
-                {
-                  add_classpath(*rep, user_dir, class_path);
-                }
+              if (!class_path.empty())
+                class_path.push_back(':');
+              class_path.append(jars);
             }
 
           TLOG_DEBUG(5) <<  "set final CLASSPATH: " << class_path ;
@@ -937,6 +1070,8 @@ static void get_parameters(
 )
 // throw ( BadProgramInfo BadTag)
 {
+  DAL_INSTRUMENT_SCOPE(GetParameters);
+
   TLOG_DEBUG(4) << " CALL get_parameters()"
             << "\n  program   = " << this_cp
             << "\n  tag       = " << &tag
@@ -1126,6 +1261,13 @@ void dunedaq::dal::ComputerProgram::get_info(
 
   get_parameters(this, program_names, search_paths, paths_to_shared_libraries, tag, host, partition);
 
+  try {
+    resolve_program(program_names, *this);
+  }
+  catch ( dunedaq::dal::NoProgramFile & ex ) {
+     throw dunedaq::dal::BadProgramInfo( ERS_HERE, UID(), "failed to resolve Program file", ex ) ;
+  }
+
 
     // Get the environment:
     //  - add environment defined by the partition's attributes (Name, IPCRef, DBPath, DBName, ...)
@@ -1135,7 +1277,7 @@ void dunedaq::dal::ComputerProgram::get_info(
   try {
     add_front_partition_environment(environment, partition); // throw no_subst_parameter
 
-    add_env_vars(environment, get_ProcessEnvironment(), nullptr);
+    add_env_vars(environment, get_ProcessEnvironment(), nullptr, &get_variables_cache(partition));
 
     add_end_partition_environment(environment, partition, nullptr, this, &tag);
   }
@@ -1146,7 +1288,7 @@ void dunedaq::dal::ComputerProgram::get_info(
     // add "PATH" and "LD_LIBRARY_PATH" variables
 
   set_path(environment, s_path_str, search_paths);
-  set_path(environment, s_ld_library_path_str, paths_to_shared_libraries);
+  set_library_path(environment, paths_to_shared_libraries, tag);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1161,13 +1303,13 @@ get_resourse_apps(
   if (p == nullptr || obj->disabled(*p, true) == false)
     {
       // test if the resource base can be casted to the application
-      if (const dunedaq::dal::BaseApplication * r = obj->cast<dunedaq::dal::BaseApplication>())
+      if (const dunedaq::dal::BaseApplication * r = dunedaq::dal::ClassMask::cast<dunedaq::dal::BaseApplication>(obj))
         {
           out.push_back(r);
         }
 
       // test if the resource base can contain nested resources
-      if (const dunedaq::dal::ResourceSet * s = obj->cast<dunedaq::dal::ResourceSet>())
+      if (const dunedaq::dal::ResourceSet * s = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(obj))
         {
           for (const auto& i : s->get_Contains())
             {
@@ -1181,7 +1323,7 @@ get_resourse_apps(
 static std::vector<const dunedaq::dal::BaseApplication *>
 get_resource_applications(const dunedaq::dal::ResourceBase * obj, const dunedaq::dal::Partition * p = nullptr)
 {
-  dunedaq::dal::TestCircularDependency cd_fuse("resource applications", obj);
+  dunedaq::dal::TestCircularDependency cd_fuse("resource applications", obj, p && dunedaq::dal::is_dependency_graph_validated(*p, obj));
   std::vector<const dunedaq::dal::BaseApplication *> out;
   get_resourse_apps(obj, out, p, cd_fuse);
   return out;
@@ -1191,58 +1333,14 @@ get_resource_applications(const dunedaq::dal::ResourceBase * obj, const dunedaq:
 ******************* ALGORITHM Segment::get_timeouts() ***********
 ******************************************************************************/
 
+static void
+get_timeouts(const dunedaq::dal::SegConfig& seg_config, int& actionTimeout, int& shortActionTimeout);
+
 void
 dunedaq::dal::Segment::get_timeouts(int& actionTimeout, int& shortActionTimeout) const
   //throws (dunedaq::dal::BadSegment)
 {
-  const dunedaq::dal::Partition * partition = get_seg_config(false)->get_partition();
-
-  actionTimeout = shortActionTimeout = 0;
-
-  for (const auto& a : get_infrastructure())
-    if (static_cast<int>(a->get_ExitTimeout()) > shortActionTimeout)
-      shortActionTimeout = a->get_ExitTimeout();
-
-  for(const auto& i : get_nested_segments())
-    {
-      if (i->disabled(*partition) == false)
-        {
-          for (const auto& it : get_infrastructure())
-            {
-              if (static_cast<int>(it->get_ExitTimeout()) > shortActionTimeout)
-                {
-                  shortActionTimeout = it->get_ExitTimeout();
-                }
-            }
-
-          int tmpLongTime, tmpShortTime;
-          i->get_timeouts(tmpLongTime, tmpShortTime);
-
-          if (tmpLongTime > actionTimeout)
-            actionTimeout = tmpLongTime;
-          if (tmpShortTime > shortActionTimeout)
-            shortActionTimeout = tmpShortTime;
-        }
-    }
-
-  for (const auto& a : get_applications())
-    {
-      if (const dunedaq::dal::RunControlApplicationBase* rcApp = a->cast<dunedaq::dal::RunControlApplicationBase>())
-        {
-          if (rcApp->get_ActionTimeout() > actionTimeout)
-            actionTimeout = rcApp->get_ActionTimeout();
-        }
-
-      if (const dunedaq::dal::BaseApplication* slApp = a->cast<dunedaq::dal::BaseApplication>())
-        {
-          if (static_cast<int>(slApp->get_ExitTimeout()) > shortActionTimeout)
-            shortActionTimeout = slApp->get_ExitTimeout();
-        }
-
-    }
-
-  actionTimeout += get_IsControlledBy()->get_ActionTimeout();
-  shortActionTimeout += get_IsControlledBy()->cast<dunedaq::dal::BaseApplication>()->get_ExitTimeout();
+  ::get_timeouts(*get_seg_config(true), actionTimeout, shortActionTimeout); // throw SegmentDisabled
 
   TLOG_DEBUG(4) <<  "Segment: " << UID() << ": Action Timeout --> " << actionTimeout << "; Exit Timeout --> " << shortActionTimeout ;
 
@@ -1324,7 +1422,7 @@ get_generic_resources(const dunedaq::dal::ResourceBase * obj, ::Configuration& d
 void
 dunedaq::dal::ResourceBase::get_resources(::Configuration& db, std::list<const Resource *>& out, const dunedaq::dal::Partition * p) const
 {
-  dunedaq::dal::TestCircularDependency cd_fuse("generic resources", this);
+  dunedaq::dal::TestCircularDependency cd_fuse("generic resources", this, p && dunedaq::dal::is_dependency_graph_validated(*p, this));
   get_generic_resources(this, db, out, p, cd_fuse);
 }
 
@@ -1372,6 +1470,10 @@ get_all_referenced(const dunedaq::dal::AppConfig * app, const std::vector<const
 
 
 namespace dunedaq::dal {
+    // Parents of segments included into the tree; the keys and values point to UIDs of segment objects
+    // (the value of root segment is empty)
+    typedef std::unordered_map<std::string_view, std::string_view> SegmentsInclusion;
+
     // This class is a friend of AppConfig and SegConfig
     class AlgorithmUtils
     {
@@ -1384,23 +1486,61 @@ namespace dunedaq::dal {
       add_applications(dunedaq::dal::Segment& seg, const dunedaq::dal::Rack * rack, const dunedaq::dal::Partition& p, const dunedaq::dal::Computer * default_host);
 
       static void
-      add_segments(dunedaq::dal::Segment& seg, const dunedaq::dal::Partition& p, const std::vector<const dunedaq::dal::Segment*>& objs, const dunedaq::dal::Rack * rack, const dunedaq::dal::Computer * default_host, dunedaq::oksdbinterfaces::map<std::string>& fuse);
+      add_segments(dunedaq::dal::Segment& seg, const dunedaq::dal::Partition& p, const std::vector<const dunedaq::dal::Segment*>& objs, const dunedaq::dal::Rack * rack, const dunedaq::dal::Computer * default_host, dunedaq::dal::SegmentsInclusion& fuse);
 
       static void
       get_applications(std::vector<const dunedaq::dal::BaseApplication *>& out, const dunedaq::dal::Segment& seg, std::set<std::string> * app_types, std::set<std::string> * segments, std::set<const dunedaq::dal::Computer *> * hosts);
 
       static AppConfig *
-      reset_app_config(dunedaq::dal::BaseApplication& app);
+      reset_app_config(dunedaq::dal::BaseApplication& app, const dunedaq::dal::Segment& seg);
 
       static SegConfig *
       reset_seg_config(dunedaq::dal::Segment& seg, const dunedaq::dal::Partition* p);
 
+      static void
+      release_generation(ApplicationConfig::Generation& g) noexcept;
+
+      static void
+      build_image(dunedaq::dal::PartitionImage& image, const dunedaq::dal::Segment& root);
+
       static const dunedaq::dal::Partition*
       get_partition(const dunedaq::dal::BaseApplication * app);
 
+      static bool
+      is_graph_validated(const dunedaq::dal::Partition& p);
+
+      static bool
+      is_graph_validated(const dunedaq::dal::Partition& p, const DalObject * obj);
+
+      static VariablesCache&
+      get_variables_cache(const dunedaq::dal::Partition& p)
+      {
+        return p.m_app_config.m_variables;
+      }
+
+      static void
+      get_timeouts(const dunedaq::dal::SegConfig& seg_config, int& actionTimeout, int& shortActionTimeout);
+
+      static std::set<const dunedaq::dal::SW_Repository *>
+      get_used_repositories(const dunedaq::dal::Partition& p);
+
+      static std::string
+      get_class_path(const dunedaq::dal::Partition& p, const std::vector<const dunedaq::dal::SW_Package*>& packages, const std::string& user_dir);
+
+      typedef ApplicationConfig::Generation::EnvironmentLayer EnvironmentLayer;
+
+      static std::shared_ptr<const EnvironmentLayer>
+      get_front_environment(const dunedaq::dal::Partition& p);
+
+      static std::shared_ptr<const EnvironmentLayer>
+      get_segments_environment(const dunedaq::dal::BaseApplication * app, const dunedaq::dal::Partition& p, const std::list<const dunedaq::dal::Segment *>& s_list, const dunedaq::dal::Tag * tag);
+
 
     private:
 
+      static std::shared_ptr<const EnvironmentLayer>
+      find_front_environment(ApplicationConfig::Generation& g, uint64_t id);
+
       static void
       add_template_application(const dunedaq::dal::TemplateApplication * a, const char * type, dunedaq::dal::Segment& seg, std::vector<const dunedaq::dal::BaseApplication *>& apps, BackupHostFactory& factory);
 
@@ -1410,14 +1550,32 @@ namespace dunedaq::dal {
       static const dunedaq::dal::Computer *
       get_host(const dunedaq::dal::Segment& seg, const dunedaq::dal::BaseApplication * base_app, const dunedaq::dal::Application * app = nullptr);
 
-      static bool
-      check_app(const dunedaq::dal::BaseApplication * app, std::set<std::string> * app_types, std::set<std::string> * use_segments, std::set<const dunedaq::dal::Computer *> * use_hosts);
+      struct ImageIndices
+      {
+        std::unordered_map<const dunedaq::dal::Computer *, uint32_t> m_hosts;
+        std::unordered_map<std::string_view, uint32_t> m_classes;
+      };
+
+      static void
+      add_to_image(dunedaq::dal::PartitionImage& image, const dunedaq::dal::Segment& seg, uint32_t parent, bool enabled, ImageIndices& indices);
+
+      static void
+      add_to_image(dunedaq::dal::PartitionImage& image, const dunedaq::dal::BaseApplication * app, uint32_t seg_idx, PartitionImage::Role role, ImageIndices& indices);
 
       static void
       check_non_template_segment(const dunedaq::dal::Segment& seg, const dunedaq::dal::BaseApplication * base_app);
 
       static void
-      set_backup_hosts(const std::string& runs_on, std::vector<const dunedaq::dal::Computer *>& template_backup_hosts, BackupHostFactory& factory);
+      set_backup_hosts(const std::string& runs_on, std::pmr::vector<const dunedaq::dal::Computer *>& template_backup_hosts, BackupHostFactory& factory);
+
+      static void
+      compute_timeouts(const ApplicationConfig::Generation& g);
+
+      static ApplicationConfig::Generation&
+      get_generation(const dunedaq::dal::Partition& p)
+      {
+        return *p.m_app_config.m_generation;
+      }
 
     };
 } // namespace dunedaq::dal
@@ -1444,7 +1602,7 @@ dunedaq::dal::AlgorithmUtils::add_normal_application(const dunedaq::dal::Applica
 {
   check_non_template_segment(seg, a);
   dunedaq::dal::BaseApplication * app_obj = const_cast<dunedaq::dal::BaseApplication *>(seg.configuration().get<dunedaq::dal::BaseApplication>(const_cast<ConfigObject&>(a->config_object()), a->UID()));
-  dunedaq::dal::AppConfig * app_config = dunedaq::dal::AlgorithmUtils::reset_app_config(*app_obj);
+  dunedaq::dal::AppConfig * app_config = dunedaq::dal::AlgorithmUtils::reset_app_config(*app_obj, seg);
   app_config->m_host = get_host(seg, a, a);
   app_config->m_segment = &seg;
   app_config->m_base_app = a;
@@ -1515,7 +1673,7 @@ dunedaq::dal::AlgorithmUtils::add_template_application(const dunedaq::dal::Templ
             }
 
           dunedaq::dal::BaseApplication * app_obj = const_cast<dunedaq::dal::BaseApplication *>(seg.configuration().get<dunedaq::dal::BaseApplication>(const_cast<ConfigObject&>(a->config_object()), app_id));
-          dunedaq::dal::AppConfig * app_config = dunedaq::dal::AlgorithmUtils::reset_app_config(*app_obj);
+          dunedaq::dal::AppConfig * app_config = dunedaq::dal::AlgorithmUtils::reset_app_config(*app_obj, seg);
           app_config->m_is_templated = true;
           app_config->m_host = h;
           set_backup_hosts(runs_on, app_config->m_template_backup_hosts, factory);
@@ -1538,7 +1696,7 @@ dunedaq::dal::AlgorithmUtils::check_non_template_segment(const dunedaq::dal::Seg
 }
 
 void
-dunedaq::dal::AlgorithmUtils::set_backup_hosts(const std::string& runs_on, std::vector<const dunedaq::dal::Computer *>& template_backup_hosts, BackupHostFactory& factory)
+dunedaq::dal::AlgorithmUtils::set_backup_hosts(const std::string& runs_on, std::pmr::vector<const dunedaq::dal::Computer *>& template_backup_hosts, BackupHostFactory& factory)
 {
   if (runs_on == dunedaq::dal::TemplateApplication::RunsOn::FirstHostWithBackup)
     {
@@ -1570,6 +1728,8 @@ add_enabled_hosts(std::vector<const dunedaq::dal::Computer *>& to, const std::ve
 void
 dunedaq::dal::AlgorithmUtils::add_applications(dunedaq::dal::Segment& seg, const dunedaq::dal::Rack * rack, const dunedaq::dal::Partition& p, const dunedaq::dal::Computer * default_host)
 {
+  DAL_TRACE_SPAN("add_applications", seg.UID());
+
   dunedaq::dal::SegConfig * seg_config = seg.get_seg_config(false);
 
   // fill hosts of segment
@@ -1624,10 +1784,10 @@ dunedaq::dal::AlgorithmUtils::add_applications(dunedaq::dal::Segment& seg, const
         {
           check_non_template_segment(seg, a);
           app_obj = const_cast<dunedaq::dal::BaseApplication *>(seg.configuration().get<dunedaq::dal::BaseApplication>(const_cast<ConfigObject&>(a->config_object()), a->UID()));
-          app_config = dunedaq::dal::AlgorithmUtils::reset_app_config(*app_obj);
+          app_config = dunedaq::dal::AlgorithmUtils::reset_app_config(*app_obj, seg);
           app_config->m_host = get_host(seg, a, a);
         }
-      else if (const dunedaq::dal::TemplateApplication * t = ctrl_obj->cast<dunedaq::dal::TemplateApplication>())
+      else if (const dunedaq::dal::TemplateApplication * t = dunedaq::dal::ClassMask::cast<dunedaq::dal::TemplateApplication>(ctrl_obj))
         {
           const std::string& t_runs_on(t->get_RunsOn());
           if(t_runs_on != dunedaq::dal::TemplateApplication::RunsOn::FirstHost && t_runs_on != dunedaq::dal::TemplateApplication::RunsOn::FirstHostWithBackup)
@@ -1638,27 +1798,27 @@ dunedaq::dal::AlgorithmUtils::add_applications(dunedaq::dal::Segment& seg, const
             }
 
           app_obj = const_cast<dunedaq::dal::BaseApplication *>(seg.configuration().get<dunedaq::dal::BaseApplication>(const_cast<ConfigObject&>(t->config_object()), seg.UID()));
-          app_config = dunedaq::dal::AlgorithmUtils::reset_app_config(*app_obj);
+          app_config = dunedaq::dal::AlgorithmUtils::reset_app_config(*app_obj, seg);
           app_config->m_is_templated = true;
           app_config->m_host = get_host(seg, t);
           set_backup_hosts(t_runs_on, app_config->m_template_backup_hosts, factory);
         }
 
       app_config->m_segment = &seg;
-      app_config->m_base_app = ctrl_obj->cast<dunedaq::dal::BaseApplication>();
+      app_config->m_base_app = dunedaq::dal::ClassMask::cast<dunedaq::dal::BaseApplication>(ctrl_obj);
       seg_config->m_controller = app_obj;
     }
 
   // add infrastructure
   for (const auto& x : seg.get_Infrastructure())
     {
-      if (seg.configuration().cast<dunedaq::dal::Resource>(x) == nullptr)
+      if (dunedaq::dal::ClassMask::castable<dunedaq::dal::Resource>(x) == false)
         {
-          if (const dunedaq::dal::InfrastructureApplication * a = x->cast<dunedaq::dal::InfrastructureApplication>())
+          if (const dunedaq::dal::InfrastructureApplication * a = dunedaq::dal::ClassMask::cast<dunedaq::dal::InfrastructureApplication>(x))
             {
               add_normal_application(a, seg, seg_config->m_infrastructure);
             }
-          else if (const dunedaq::dal::TemplateApplication * t = x->cast<dunedaq::dal::TemplateApplication>())
+          else if (const dunedaq::dal::TemplateApplication * t = dunedaq::dal::ClassMask::cast<dunedaq::dal::TemplateApplication>(x))
             {
               add_template_application(t, "infrastructure", seg, seg_config->m_infrastructure, factory);
             }
@@ -1671,11 +1831,11 @@ dunedaq::dal::AlgorithmUtils::add_applications(dunedaq::dal::Segment& seg, const
       // get enabled resources
       for (const auto& j : get_resource_applications(x, &p))
         {
-          if (const dunedaq::dal::Application * a = j->cast<dunedaq::dal::Application>())
+          if (const dunedaq::dal::Application * a = dunedaq::dal::ClassMask::cast<dunedaq::dal::Application>(j))
             {
               add_normal_application(a, seg, seg_config->m_applications);
             }
-          else if (const dunedaq::dal::TemplateApplication * t = j->cast<dunedaq::dal::TemplateApplication>())
+          else if (const dunedaq::dal::TemplateApplication * t = dunedaq::dal::ClassMask::cast<dunedaq::dal::TemplateApplication>(j))
             {
               add_template_application(t, "resource", seg, seg_config->m_applications, factory);
             }
@@ -1685,13 +1845,13 @@ dunedaq::dal::AlgorithmUtils::add_applications(dunedaq::dal::Segment& seg, const
   // add applications
   for (const auto& x : seg.get_Applications())
     {
-      if (seg.configuration().cast<dunedaq::dal::Resource>(x) == nullptr)
+      if (dunedaq::dal::ClassMask::castable<dunedaq::dal::Resource>(x) == false)
         {
-          if (const dunedaq::dal::Application * a = x->cast<dunedaq::dal::Application>())
+          if (const dunedaq::dal::Application * a = dunedaq::dal::ClassMask::cast<dunedaq::dal::Application>(x))
             {
               add_normal_application(a, seg, seg_config->m_applications);
             }
-          else if (const dunedaq::dal::TemplateApplication * t = x->cast<dunedaq::dal::TemplateApplication>())
+          else if (const dunedaq::dal::TemplateApplication * t = dunedaq::dal::ClassMask::cast<dunedaq::dal::TemplateApplication>(x))
             {
               add_template_application(t, "normal", seg, seg_config->m_applications, factory);
             }
@@ -1710,12 +1870,12 @@ seg_config_to_name(const std::string& s)
 }
 
 static void
-check_mulpiple_inclusion(dunedaq::oksdbinterfaces::map<std::string>& fuse, const std::string& id, const std::string& parent)
+check_mulpiple_inclusion(const dunedaq::dal::SegmentsInclusion& fuse, const std::string& id, const std::string& parent)
 {
-  auto ret = fuse.emplace(id,parent);
-  if(ret.second == false)
+  auto it = fuse.find(id);
+  if(it != fuse.end())
     {
-      throw dunedaq::dal::SegmentIncludedMultipleTimes( ERS_HERE, id, seg_config_to_name((*ret.first).second), seg_config_to_name(parent) );
+      throw dunedaq::dal::SegmentIncludedMultipleTimes( ERS_HERE, id, seg_config_to_name(std::string(it->second)), seg_config_to_name(parent) );
     }
 }
 
@@ -1726,8 +1886,10 @@ dunedaq::dal::AlgorithmUtils::add_segments(
     const std::vector<const dunedaq::dal::Segment*>& objs,
     const dunedaq::dal::Rack * rack,
     const dunedaq::dal::Computer * default_host,
-    dunedaq::oksdbinterfaces::map<std::string>& fuse)
+    dunedaq::dal::SegmentsInclusion& fuse)
 {
+  DAL_TRACE_SPAN("add_segments", seg.UID());
+
   dunedaq::dal::SegConfig * seg_config = seg.get_seg_config(false);
 
   if(const dunedaq::dal::Computer * c = find_enabled(seg.get_Hosts()))
@@ -1742,7 +1904,7 @@ dunedaq::dal::AlgorithmUtils::add_segments(
 
   for(const auto& x : objs)
     {
-      if(const dunedaq::dal::TemplateSegment * ts = x->cast<TemplateSegment>())
+      if(const dunedaq::dal::TemplateSegment * ts = dunedaq::dal::ClassMask::cast<dunedaq::dal::TemplateSegment>(x))
         {
           bool ts_is_disabled = ts->disabled(p, true);
 
@@ -1757,6 +1919,7 @@ dunedaq::dal::AlgorithmUtils::add_segments(
               check_mulpiple_inclusion(fuse, id, seg.p_UID);
 
               dunedaq::dal::Segment * s = const_cast<dunedaq::dal::Segment *>(p.configuration().get<dunedaq::dal::Segment>(const_cast<ConfigObject&>(ts->config_object()), id));
+              fuse.emplace(s->UID(), seg.p_UID);
               dunedaq::dal::SegConfig * nested_seg_config = dunedaq::dal::AlgorithmUtils::reset_seg_config(*s, &p);
               nested_seg_config->m_is_disabled = is_disabled;
               nested_seg_config->m_is_templated = true;
@@ -1773,6 +1936,7 @@ dunedaq::dal::AlgorithmUtils::add_segments(
       else
         {
           check_mulpiple_inclusion(fuse, x->UID(), seg.p_UID);
+          fuse.emplace(x->UID(), seg.p_UID);
 
           dunedaq::dal::Segment * s = const_cast<dunedaq::dal::Segment *>(p.configuration().get<dunedaq::dal::Segment>(const_cast<ConfigObject&>(x->config_object()), x->UID()));
           dunedaq::dal::SegConfig * nested_seg_config = dunedaq::dal::AlgorithmUtils::reset_seg_config(*s, &p);
@@ -1789,240 +1953,741 @@ dunedaq::dal::AlgorithmUtils::add_segments(
 
 
 /**
- *  Function returns true if application's type is listed by the app_types,
- *  the segment is listed in the use_segments and
- *  the host is listed in use_hosts (if containers are defined)
+ *  Function returns applications of segment subtree selected from the image
+ *  by application's type listed by the app_types, the segment listed in the use_segments and
+ *  the host listed in use_hosts (if containers are defined)
  */
 
-bool
-dunedaq::dal::AlgorithmUtils::check_app(const dunedaq::dal::BaseApplication * app, std::set<std::string> * app_types, std::set<std::string> * use_segments, std::set<const dunedaq::dal::Computer *> * use_hosts)
-{
-  TLOG_DEBUG( 5) <<
-    "check_app(app=" << app->UID() << ", seg=" << app->get_segment() << ", host=" << app->get_host() << "):"
-    " app_types=" << (app_types && app_types->find(app->class_name()) == app_types->end()) <<
-    " use_segments=" << (use_segments && use_segments->find(app->get_segment()->UID()) == use_segments->end()) <<
-    " use_hosts=" << (use_hosts && use_hosts->find(app->get_host()) == use_hosts->end());
-
-  return (
-    (
-      (app_types && app_types->find(app->class_name()) == app_types->end()) ||
-      (use_segments && use_segments->find(app->get_segment()->UID()) == use_segments->end()) ||
-      (use_hosts && use_hosts->find(app->get_host()) == use_hosts->end())
-    ) ? false : true
-  );
-}
-
 void
-dunedaq::dal::AlgorithmUtils::get_applications(std::vector<const dunedaq::dal::BaseApplication *>& out, const dunedaq::dal::Segment& seg, std::set<std::string> * app_types, std::set<std::string> * segments, std::set<const dunedaq::dal::Computer *> * hosts)
+dunedaq::dal::PartitionImage::select(std::vector<const dunedaq::dal::BaseApplication *>& out, uint32_t seg_idx, const std::set<std::string> * app_types, const std::set<std::string> * use_segments, const std::set<const dunedaq::dal::Computer *> * use_hosts) const
 {
-  SegConfig * seg_config = seg.get_seg_config(false);
+  const uint32_t begin = m_seg_apps_begin[seg_idx];
+  const uint32_t end = m_seg_apps_end[seg_idx];
 
-  // return, if segment is disabled
-  if (seg_config->is_disabled() == true)
+  if (app_types == nullptr && use_segments == nullptr && use_hosts == nullptr)
     {
-      TLOG_DEBUG( 3) <<  "segment " << seg.UID() << " is disabled"  ;
+      out.insert(out.end(), m_apps.begin() + begin, m_apps.begin() + end);
       return;
     }
 
-  // check controller
-    {
-      if (check_app(seg_config->m_controller, app_types, segments, hosts))
-        {
-          out.push_back(seg_config->m_controller);
-        }
-    }
+  // convert selection criteria into masks indexed by class, segment and host indices
+
+  std::vector<uint8_t> class_mask(m_class_names.size(), 1);
+  std::vector<uint8_t> seg_mask(m_segments.size(), 1);
+  std::vector<uint8_t> host_mask(m_hosts.size(), 1);
 
-  // check infrastructure
-  for (const auto& x : seg_config->m_infrastructure)
-    if (check_app(x, app_types, segments, hosts))
-      out.push_back(x);
+  if (app_types)
+    for (uint32_t i = 0; i < class_mask.size(); ++i)
+      class_mask[i] = (app_types->find(*m_class_names[i]) != app_types->end());
 
-  // check applications
-  for (const auto& x : seg_config->m_applications)
-    if (check_app(x, app_types, segments, hosts))
-      out.push_back(x);
+  if (use_segments)
+    for (uint32_t i = 0; i < seg_mask.size(); ++i)
+      seg_mask[i] = (use_segments->find(m_segments[i]->UID()) != use_segments->end());
 
-  // check nested segments
-  for (const auto& x : seg_config->m_nested_segments)
-    get_applications(out, *x, app_types, segments, hosts);
+  if (use_hosts)
+    for (uint32_t i = 0; i < host_mask.size(); ++i)
+      host_mask[i] = (use_hosts->find(m_hosts[i]) != use_hosts->end());
+
+  for (uint32_t i = begin; i < end; ++i)
+    if (class_mask[m_app_class[i]] & seg_mask[m_app_segment[i]] & host_mask[m_app_host[i]])
+      out.push_back(m_apps[i]);
 }
 
-dunedaq::dal::AppConfig *
-dunedaq::dal::AlgorithmUtils::reset_app_config(dunedaq::dal::BaseApplication& app)
+dunedaq::dal::PartitionImage::Lifetime
+dunedaq::dal::PartitionImage::get_lifetime(std::string_view value)
 {
-  if (app.p_app_config)
-    app.p_app_config->clear();
+  if (value == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::Boot_Shutdown)
+    return BootShutdown;
+  else if (value == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::Configure_Unconfigure)
+    return ConfigureUnconfigure;
+  else if (value == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::SOR_EOR)
+    return SorEor;
+  else if (value == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::EOR_SOR)
+    return EorSor;
+  else if (value == dunedaq::dal::CustomLifetimeApplicationBase::Lifetime::UserDefined_Shutdown)
+    return UserDefinedShutdown;
   else
-    app.p_app_config.reset(new AppConfig());
-
-  return app.p_app_config.get();
+    return NoLifetime;
 }
 
-dunedaq::dal::SegConfig *
-dunedaq::dal::AlgorithmUtils::reset_seg_config(dunedaq::dal::Segment& seg, const dunedaq::dal::Partition* p)
+uint32_t
+dunedaq::dal::PartitionImage::get_first_application(uint32_t host_idx, CategoryMask categories) const
 {
-  if (seg.p_seg_config)
-    seg.p_seg_config->clear(p);
-  else
-    seg.p_seg_config.reset(new SegConfig(p));
+  uint32_t first = npos;
 
-  return seg.p_seg_config.get();
+  for (uint32_t c = 0; c < num_of_categories; ++c)
+    if (categories & (1 << c))
+      first = std::min(first, m_host_first_app[host_idx * num_of_categories + c]);
+
+  return first;
 }
 
-const dunedaq::dal::Partition*
-dunedaq::dal::AlgorithmUtils::get_partition(const dunedaq::dal::BaseApplication * app)
+void
+dunedaq::dal::PartitionImage::select_hosts(std::vector<const dunedaq::dal::Computer *>& out, CategoryMask categories) const
 {
-  return app->get_segment()->get_seg_config(false)->get_partition();
+  std::vector<std::vector<const dunedaq::dal::Computer *>> v;
+  select_hosts(v, std::vector<CategoryMask>{categories});
+  out.insert(out.end(), v[0].begin(), v[0].end());
 }
 
-const dunedaq::dal::Segment *
-dunedaq::dal::Partition::get_segment(const std::string& name) const
+  // the hosts are ordered by index of their first application of selected categories
+
+void
+dunedaq::dal::PartitionImage::select_hosts(std::vector<std::vector<const dunedaq::dal::Computer *>>& out, const std::vector<CategoryMask>& categories) const
 {
-  if (m_app_config.m_root_segment == nullptr)
-    {
-      std::lock_guard<std::mutex> scoped_lock(m_app_config.m_root_segment_mutex);
+  std::vector<std::vector<std::pair<uint32_t, const dunedaq::dal::Computer *>>> selected(categories.size());
 
-      if (m_app_config.m_root_segment == nullptr)
-        {
-          const dunedaq::dal::OnlineSegment * onlseg = get_OnlineInfrastructure();
+  for (uint32_t i = 0; i < m_hosts.size(); ++i)
+    for (std::size_t j = 0; j < categories.size(); ++j)
+      if (m_host_categories[i] & categories[j])
+        selected[j].emplace_back(get_first_application(i, categories[j]), m_hosts[i]);
 
-          dunedaq::dal::Segment * root_segment = const_cast<dunedaq::dal::Segment *>(const_cast<Configuration&>(p_db).get<dunedaq::dal::Segment>(const_cast<ConfigObject&>(onlseg->config_object()), onlseg->UID()));
+  out.resize(categories.size());
 
-          // reinitialize seg config
-          dunedaq::dal::AlgorithmUtils::reset_seg_config(*root_segment, this);
+  for (std::size_t j = 0; j < categories.size(); ++j)
+    {
+      std::sort(selected[j].begin(), selected[j].end(), [](const auto& a, const auto& b) { return a.first < b.first; });
 
-          root_segment->p_seg_config->m_base_segment = root_segment;
+      for (const auto& x : selected[j])
+        out[j].push_back(x.second);
+    }
+}
 
-          const dunedaq::dal::Computer * default_host = get_DefaultHost();
+void
+dunedaq::dal::AlgorithmUtils::get_applications(std::vector<const dunedaq::dal::BaseApplication *>& out, const dunedaq::dal::Segment& seg, std::set<std::string> * app_types, std::set<std::string> * segments, std::set<const dunedaq::dal::Computer *> * hosts)
+{
+  SegConfig * seg_config = seg.get_seg_config(false);
 
-          if (default_host && default_host->get_State() == false)
-            {
-              default_host = nullptr;
-            }
+  // keep the generation alive while its image is read; the tree may be released by another thread
 
-          dunedaq::oksdbinterfaces::map<std::string> fuse;
-          fuse[root_segment->UID()] = "";
+  const std::shared_ptr<ApplicationConfig::Generation> g(seg_config->m_partition->m_app_config.__get_generation());
 
-          dunedaq::dal::AlgorithmUtils::add_segments(*root_segment, *this, get_Segments(), nullptr, default_host, fuse);
+  if (!g || seg_config->m_image_idx >= g->m_image.m_segments.size() || g->m_image.m_segments[seg_config->m_image_idx] != &seg)
+    throw dunedaq::dal::NotInitedByDalAlgorithm(ERS_HERE, seg.UID(), seg.class_name(), (void*)&seg, "Segment::get_all_applications()");
 
-          for (const auto& a : get_OnlineInfrastructureApplications())
-            {
-              if (const dunedaq::dal::ResourceBase * r = a->cast<dunedaq::dal::ResourceBase>())
-                {
-                  if (r->disabled(*this, true) == true)
-                    continue;
-                }
+  const dunedaq::dal::PartitionImage& image(g->m_image);
 
-              std::vector<const dunedaq::dal::BaseApplication *>& apps(a->cast<dunedaq::dal::InfrastructureBase>() ? root_segment->get_seg_config(false)->m_infrastructure : root_segment->get_seg_config(false)->m_applications);
-              dunedaq::dal::AlgorithmUtils::add_normal_application(a, *root_segment, apps);
-            }
+  // return, if segment is disabled
+  if (image.m_seg_enabled[seg_config->m_image_idx] == 0)
+    {
+      TLOG_DEBUG( 3) <<  "segment " << seg.UID() << " is disabled"  ;
+      return;
+    }
 
-          // check duplicated application IDs
+  image.select(out, seg_config->m_image_idx, app_types, segments, hosts);
+}
 
-          // FIXME 2022-06-02:
-          //   move check to get_all_applications() in next release tdaq-09-05-00
-          //   do it once per load/reload modifying ApplicationConfig
+void
+dunedaq::dal::AlgorithmUtils::add_to_image(dunedaq::dal::PartitionImage& image, const dunedaq::dal::BaseApplication * app, uint32_t seg_idx, PartitionImage::Role role, ImageIndices& indices)
+{
+  const dunedaq::dal::Computer * host = app->get_host();
 
-          struct Compare {
-              bool operator()(const dunedaq::dal::BaseApplication *lhs, const dunedaq::dal::BaseApplication *rhs) const
-              { return (lhs->UID() < rhs->UID()); };
-          };
+  auto h = indices.m_hosts.emplace(host, image.m_hosts.size());
+  if (h.second)
+    {
+      image.m_hosts.push_back(host);
+      image.m_host_categories.push_back(0);
+      image.m_host_first_app.resize(image.m_host_first_app.size() + PartitionImage::num_of_categories, PartitionImage::npos);
+    }
 
-          struct ValidateAppID
-          {
-            std::map<const dunedaq::dal::BaseApplication *, const dunedaq::dal::Segment *, Compare> m_map;
+  // lifetime and restart policy are defined by the base application object
 
-            static std::string
-            str(const dunedaq::dal::BaseApplication * x, const dunedaq::dal::Segment * y)
-            {
-              std::ostringstream s;
-              s << '\"' << x << "\" in segment \"" << y->UID() << '\"';
-              return s.str();
-            }
+  const dunedaq::dal::BaseApplication * base_app = app->get_base_app();
+  const dunedaq::dal::CustomLifetimeApplicationBase * ca = base_app->cast<dunedaq::dal::CustomLifetimeApplicationBase>();
 
-            void
-            check_duplicated(const dunedaq::dal::BaseApplication * a, const dunedaq::dal::Segment * s)
-            {
-              auto ret = m_map.emplace(a, s);
+  const bool restartable =
+    base_app->get_IfExitsUnexpectedly() == dunedaq::dal::BaseApplication::IfExitsUnexpectedly::Restart ||
+    base_app->get_IfFailsToStart() == dunedaq::dal::BaseApplication::IfFailsToStart::Restart;
 
-              if (ret.second == false)
-                throw dunedaq::dal::DuplicatedApplicationID( ERS_HERE, ValidateAppID::str(a, s), ValidateAppID::str(ret.first->first, ret.first->second) );
-            }
+  const uint8_t category = PartitionImage::get_category(ca ? PartitionImage::get_lifetime(ca->get_Lifetime()) : PartitionImage::NoLifetime, restartable);
 
-            void
-            check_duplicated(const dunedaq::dal::Segment *s)
-            {
-              SegConfig * seg_config = s->get_seg_config(false);
+  image.m_host_categories[h.first->second] |= (1 << category);
 
-              if (seg_config->is_disabled() == false)
-                {
-                  check_duplicated(seg_config->get_controller(), s);
+  uint32_t& first_app(image.m_host_first_app[h.first->second * PartitionImage::num_of_categories + category]);
+  if (first_app == PartitionImage::npos)
+    first_app = image.m_apps.size();
 
-                  // check infrastructure
-                  for (const auto &x : seg_config->get_infrastructure())
-                    check_duplicated(x, s);
+  const std::string& class_name = app->class_name();
 
-                  // check applications
-                  for (const auto &x : seg_config->get_applications())
-                    check_duplicated(x, s);
+  auto c = indices.m_classes.emplace(std::string_view(class_name), image.m_class_names.size());
+  if (c.second)
+    image.m_class_names.push_back(&class_name);
 
-                  // check nested segments
-                  for (const auto &x : seg_config->get_nested_segments())
-                    check_duplicated(x);
-                }
-            }
-          };
+  image.m_apps.push_back(app);
+  image.m_app_segment.push_back(seg_idx);
+  image.m_app_host.push_back(h.first->second);
+  image.m_app_class.push_back(c.first->second);
+  image.m_app_role.push_back(role);
+  image.m_app_category.push_back(category);
+}
 
-          ValidateAppID test;
-          test.check_duplicated(root_segment);
+  // the segments are added in pre-order; the applications of disabled segments and their nested segments are not added
 
-          m_app_config.m_root_segment.store(root_segment);
-        }
-    }
+void
+dunedaq::dal::AlgorithmUtils::add_to_image(dunedaq::dal::PartitionImage& image, const dunedaq::dal::Segment& seg, uint32_t parent, bool enabled, ImageIndices& indices)
+{
+  SegConfig * seg_config = seg.p_seg_config;
 
-  const dunedaq::dal::Segment * seg = p_db.find<dunedaq::dal::Segment>(name);
+  const uint32_t idx = image.m_segments.size();
 
-  if(seg == nullptr)
-    {
-      std::string::size_type idx = name.find(':');
+  enabled = (enabled && seg_config->m_is_disabled == false);
 
-      if (idx != std::string::npos)
-        {
-          std::string seg_id = name.substr(0, idx);
+  seg_config->m_image_idx = idx;
 
-          seg = p_db.get<Segment>(seg_id);
+  image.m_segments.push_back(&seg);
+  image.m_seg_parent.push_back(parent);
+  image.m_seg_enabled.push_back(enabled);
+  image.m_seg_templated.push_back(seg_config->m_is_templated);
+  image.m_seg_apps_begin.push_back(image.m_apps.size());
+  image.m_seg_apps_end.push_back(image.m_apps.size());
 
-          if (seg == nullptr)
-            {
-              std::ostringstream text;
-              text << "cannot find template segment object \'" << seg_id << '\'';
-              throw dunedaq::dal::CannotFindSegmentByName(ERS_HERE, name, text.str());
-            }
+  if (enabled)
+    {
+      add_to_image(image, seg_config->m_controller, idx, PartitionImage::Controller, indices);
 
-          if (const dunedaq::dal::TemplateSegment * ts = seg->cast<TemplateSegment>())
-            {
-              std::ostringstream text;
-              text << "template segment " << ts << " does not have rack \'" << name.substr(idx + 1) << '\'';
-              throw dunedaq::dal::CannotFindSegmentByName(ERS_HERE, name, text.str());
-            }
-          else
-            {
-              std::ostringstream text;
-              text << "object \'" << seg_id << "\' is not template segment";
-              throw dunedaq::dal::CannotFindSegmentByName(ERS_HERE, name, text.str());
-            }
-        }
-      else
-        {
-          throw dunedaq::dal::CannotFindSegmentByName(ERS_HERE, name, "no such non-template segment object");
-        }
+      for (const auto& x : seg_config->m_infrastructure)
+        add_to_image(image, x, idx, PartitionImage::Infrastructure, indices);
+
+      for (const auto& x : seg_config->m_applications)
+        add_to_image(image, x, idx, PartitionImage::Application, indices);
     }
 
-  return seg;
+  for (const auto& x : seg_config->m_nested_segments)
+    add_to_image(image, *x, idx, enabled, indices);
+
+  image.m_seg_apps_end[idx] = image.m_apps.size();
 }
 
-const dunedaq::dal::AppConfig *
-dunedaq::dal::BaseApplication::get_app_config(bool no_except) const
+void
+dunedaq::dal::AlgorithmUtils::build_image(dunedaq::dal::PartitionImage& image, const dunedaq::dal::Segment& root)
+{
+  DAL_TRACE_SPAN("build_image", root.UID());
+
+  ImageIndices indices;
+
+  add_to_image(image, root, PartitionImage::npos, true, indices);
+
+  // build nested segments index from parents; the children keep order of the nested segments
+
+  const uint32_t num = image.m_segments.size();
+
+  image.m_seg_children_idx.assign(num + 1, 0);
+
+  for (uint32_t i = 1; i < num; ++i)
+    image.m_seg_children_idx[image.m_seg_parent[i] + 1]++;
+
+  for (uint32_t i = 0; i < num; ++i)
+    image.m_seg_children_idx[i + 1] += image.m_seg_children_idx[i];
+
+  image.m_seg_children.resize(num - 1);
+
+  std::vector<uint32_t> pos(image.m_seg_children_idx.begin(), image.m_seg_children_idx.end() - 1);
+
+  for (uint32_t i = 1; i < num; ++i)
+    image.m_seg_children[pos[image.m_seg_parent[i]]++] = i;
+
+  TLOG_DEBUG(3) << "build image of " << num << " segments, " << image.m_apps.size() << " applications, " << image.m_hosts.size() << " hosts and " << image.m_class_names.size() << " application classes";
+}
+
+
+  /**
+   *  Compute timeouts of all enabled segments by single post-order pass over the image:
+   *  the segments are numbered in pre-order, so the nested segments are computed before their parent.
+   *  The action timeout of segment is the maximum of nested segments timeouts and run control applications
+   *  action timeouts; the short action timeout is the maximum of nested segments timeouts and exit timeouts
+   *  of infrastructure and other applications. The timeouts of the segment controller are added to both.
+   */
+
+void
+dunedaq::dal::AlgorithmUtils::compute_timeouts(const ApplicationConfig::Generation& g)
+{
+  DAL_TRACE_SPAN("compute_timeouts");
+
+  const dunedaq::dal::PartitionImage& image(g.m_image);
+
+  for (uint32_t idx = image.m_segments.size(); idx-- > 0;)
+    {
+      const dunedaq::dal::Segment * seg = image.m_segments[idx];
+      SegConfig * seg_config = seg->p_seg_config;
+
+      if (seg_config->m_is_disabled)
+        continue;
+
+      int actionTimeout = 0, shortActionTimeout = 0;
+
+      for (const auto& a : seg_config->m_infrastructure)
+        if (static_cast<int>(a->get_ExitTimeout()) > shortActionTimeout)
+          shortActionTimeout = a->get_ExitTimeout();
+
+      for (uint32_t i = image.m_seg_children_idx[idx]; i < image.m_seg_children_idx[idx + 1]; ++i)
+        {
+          const SegConfig * nested = image.m_segments[image.m_seg_children[i]]->p_seg_config;
+
+          if (nested->m_is_disabled == false)
+            {
+              if (nested->m_action_timeout > actionTimeout)
+                actionTimeout = nested->m_action_timeout;
+              if (nested->m_short_action_timeout > shortActionTimeout)
+                shortActionTimeout = nested->m_short_action_timeout;
+            }
+        }
+
+      for (const auto& a : seg_config->m_applications)
+        {
+          if (const dunedaq::dal::RunControlApplicationBase* rcApp = dunedaq::dal::ClassMask::cast<dunedaq::dal::RunControlApplicationBase>(a))
+            {
+              if (rcApp->get_ActionTimeout() > actionTimeout)
+                actionTimeout = rcApp->get_ActionTimeout();
+            }
+
+          if (static_cast<int>(a->get_ExitTimeout()) > shortActionTimeout)
+            shortActionTimeout = a->get_ExitTimeout();
+        }
+
+      seg_config->m_action_timeout = actionTimeout + seg->get_IsControlledBy()->get_ActionTimeout();
+      seg_config->m_short_action_timeout = shortActionTimeout + seg->get_IsControlledBy()->cast<dunedaq::dal::BaseApplication>()->get_ExitTimeout();
+    }
+}
+
+void
+dunedaq::dal::AlgorithmUtils::get_timeouts(const dunedaq::dal::SegConfig& seg_config, int& actionTimeout, int& shortActionTimeout)
+{
+  const std::shared_ptr<ApplicationConfig::Generation> g(seg_config.m_partition->m_app_config.__get_generation());
+
+  // the timeouts are computed for SegConfig objects of current generation
+
+  if (!g || std::find(g->m_seg_configs.begin(), g->m_seg_configs.end(), &seg_config) == g->m_seg_configs.end())
+    throw dunedaq::dal::NotInitedObject(ERS_HERE, "SegConfig", (void*)&seg_config);
+
+  std::call_once(g->m_timeouts_flag, [&g]() { compute_timeouts(*g); });
+
+  actionTimeout = seg_config.m_action_timeout;
+  shortActionTimeout = seg_config.m_short_action_timeout;
+}
+
+  // the AppConfig and SegConfig objects are allocated from the arena of current tree generation;
+  // they are never destroyed individually and are released together with the generation
+
+dunedaq::dal::AppConfig *
+dunedaq::dal::AlgorithmUtils::reset_app_config(dunedaq::dal::BaseApplication& app, const dunedaq::dal::Segment& seg)
+{
+  ApplicationConfig::Generation& g(get_generation(*seg.p_seg_config->m_partition));
+
+  g.m_applications.push_back(&app);
+
+  app.p_app_config = new (g.m_arena.allocate(sizeof(AppConfig), alignof(AppConfig))) AppConfig(&g.m_arena);
+  g.m_app_configs.push_back(app.p_app_config);
+
+  return app.p_app_config;
+}
+
+dunedaq::dal::SegConfig *
+dunedaq::dal::AlgorithmUtils::reset_seg_config(dunedaq::dal::Segment& seg, const dunedaq::dal::Partition* p)
+{
+  ApplicationConfig::Generation& g(get_generation(*p));
+
+  g.m_segments.push_back(&seg);
+
+  seg.p_seg_config = new (g.m_arena.allocate(sizeof(SegConfig), alignof(SegConfig))) SegConfig(p);
+  g.m_seg_configs.push_back(seg.p_seg_config);
+
+  return seg.p_seg_config;
+}
+
+void
+dunedaq::dal::AlgorithmUtils::release_generation(ApplicationConfig::Generation& g) noexcept
+{
+  // a segment may be shared by several partitions; do not reset pointers set by another one
+
+  for (size_t i = 0; i < g.m_applications.size(); ++i)
+    if (g.m_applications[i]->p_app_config == g.m_app_configs[i])
+      g.m_applications[i]->p_app_config = nullptr;
+
+  for (size_t i = 0; i < g.m_segments.size(); ++i)
+    if (g.m_segments[i]->p_seg_config == g.m_seg_configs[i])
+      g.m_segments[i]->p_seg_config = nullptr;
+}
+
+void
+dunedaq::dal::ApplicationConfig::__release_generation() noexcept
+{
+  if (m_generation)
+    {
+      dunedaq::dal::AlgorithmUtils::release_generation(*m_generation);
+      m_generation.reset();
+    }
+}
+
+  // the generation may be destroyed by the last reader after it was replaced,
+  // so it does not reset pointers of generated objects (see ApplicationConfig::__release_generation())
+
+dunedaq::dal::ApplicationConfig::Generation::~Generation()
+{
+  // the vectors of SegConfig objects use the heap
+
+  for (auto& x : m_seg_configs)
+    x->~SegConfig();
+}
+
+const dunedaq::dal::Partition*
+dunedaq::dal::AlgorithmUtils::get_partition(const dunedaq::dal::BaseApplication * app)
+{
+  return app->get_segment()->get_seg_config(false)->get_partition();
+}
+
+  // Check that applications of the image have different IDs. The IDs are hashed once and inserted into
+  // hash tables; for partitions with many applications the tables are split by hash between threads
+  // (the number of threads can be set by DAL_CHECK_THREADS process environment variable, 1 disables).
+  // In any case the first duplicated application in the image order is reported, as by serial check.
+
+namespace {
+
+  struct HashedID
+  {
+    std::string_view m_id;
+    size_t m_hash;
+
+    bool
+    operator==(const HashedID& other) const
+    {
+      return m_id == other.m_id;
+    }
+  };
+
+  struct HashedIDHash
+  {
+    size_t
+    operator()(const HashedID& x) const
+    {
+      return x.m_hash;
+    }
+  };
+
+  struct DuplicatedAppID
+  {
+    uint32_t m_app = dunedaq::dal::PartitionImage::npos;   // index of first duplicated application
+    uint32_t m_previous = dunedaq::dal::PartitionImage::npos;   // index of application with the same ID
+  };
+
+  void
+  find_duplicated_app_id(const dunedaq::dal::PartitionImage& image, const std::vector<size_t>& hashes, size_t shard, size_t num_of_shards, DuplicatedAppID& out)
+  {
+    const auto& apps = image.get_applications();
+
+    std::unordered_map<HashedID, uint32_t, HashedIDHash> ids;
+    ids.reserve(apps.size() / num_of_shards + 1);
+
+    for (uint32_t i = 0; i < apps.size(); ++i)
+      if (hashes[i] % num_of_shards == shard)
+        {
+          auto ret = ids.emplace(HashedID{apps[i]->UID(), hashes[i]}, i);
+
+          if (ret.second == false)
+            {
+              out.m_app = i;
+              out.m_previous = ret.first->second;
+              return;
+            }
+        }
+  }
+
+  unsigned int
+  get_check_threads(size_t num_of_apps)
+  {
+    if (const char * s = get_env("DAL_CHECK_THREADS"))
+      return std::max(atoi(s), 1);
+
+    if (num_of_apps < 16384)
+      return 1;
+
+    return std::clamp(std::thread::hardware_concurrency(), 1U, 8U);
+  }
+
+  std::string
+  app_in_segment_to_str(const dunedaq::dal::BaseApplication * x, const dunedaq::dal::Segment * y)
+  {
+    std::ostringstream s;
+    s << '\"' << x << "\" in segment \"" << y->UID() << '\"';
+    return s.str();
+  }
+
+  void
+  check_duplicated_app_ids(const dunedaq::dal::PartitionImage& image)
+  {
+    const auto& apps = image.get_applications();
+    const size_t num_of_threads = std::min<size_t>(get_check_threads(apps.size()), apps.size() + 1);
+
+    std::vector<size_t> hashes(apps.size());
+    std::vector<DuplicatedAppID> result(num_of_threads);
+
+    auto hash_range = [&](size_t idx)
+      {
+        const size_t end = apps.size() * (idx + 1) / num_of_threads;
+        for (size_t i = apps.size() * idx / num_of_threads; i < end; ++i)
+          hashes[i] = std::hash<std::string_view>()(apps[i]->UID());
+      };
+
+    auto find_in_shard = [&](size_t idx)
+      {
+        find_duplicated_app_id(image, hashes, idx, num_of_threads, result[idx]);
+      };
+
+    // run function for each thread index; the calling thread runs index 0
+
+    auto run = [num_of_threads](const std::function<void(size_t)>& f)
+      {
+        std::vector<std::thread> threads;
+        threads.reserve(num_of_threads - 1);
+
+        for (size_t i = 1; i < num_of_threads; ++i)
+          threads.emplace_back(f, i);
+
+        f(0);
+
+        for (auto& t : threads)
+          t.join();
+      };
+
+    run(hash_range);
+    run(find_in_shard);
+
+    const DuplicatedAppID& first = *std::min_element(result.begin(), result.end(), [](const DuplicatedAppID& a, const DuplicatedAppID& b) { return a.m_app < b.m_app; });
+
+    if (first.m_app != dunedaq::dal::PartitionImage::npos)
+      {
+        const auto& apps_segments = image.get_application_segments();
+        const auto& segments = image.get_segments();
+
+        throw dunedaq::dal::DuplicatedApplicationID(
+          ERS_HERE,
+          app_in_segment_to_str(apps[first.m_app], segments[apps_segments[first.m_app]]),
+          app_in_segment_to_str(apps[first.m_previous], segments[apps_segments[first.m_previous]])
+        );
+      }
+  }
+}
+
+
+bool
+dunedaq::dal::AlgorithmUtils::is_graph_validated(const dunedaq::dal::Partition& p)
+{
+  const ApplicationConfig& config(p.m_app_config);
+
+  ApplicationConfig::GraphState state = config.m_graph_state.load();
+
+  if (state == ApplicationConfig::GraphNotValidated)
+    {
+      std::lock_guard<std::mutex> scoped_lock(config.m_graph_mutex);
+
+      state = config.m_graph_state.load();
+
+      if (state == ApplicationConfig::GraphNotValidated)
+        {
+          DAL_TRACE_SPAN("validate_graph", p.UID());
+
+          std::string cycle;
+
+          try
+            {
+              config.m_graph_objects.clear();
+              cycle = dunedaq::dal::find_dependency_cycle(p, &config.m_graph_objects);
+            }
+          catch (dunedaq::oksdbinterfaces::Exception& ex)
+            {
+              cycle = ex.what();
+            }
+
+          if (cycle.empty())
+            {
+              state = ApplicationConfig::GraphAcyclic;
+              TLOG_DEBUG(2) << "objects graph of " << &p << " has no circular dependencies, skip recursion fuses";
+            }
+          else
+            {
+              state = ApplicationConfig::GraphHasCycle;
+              ers::error(dunedaq::dal::FoundDependencyCycle(ERS_HERE, cycle));
+            }
+
+          config.m_graph_state.store(state);
+        }
+    }
+
+  return (state == ApplicationConfig::GraphAcyclic);
+}
+
+bool
+dunedaq::dal::AlgorithmUtils::is_graph_validated(const dunedaq::dal::Partition& p, const DalObject * obj)
+{
+  if (!is_graph_validated(p))
+    return false;
+
+  const ApplicationConfig& config(p.m_app_config);
+
+  std::lock_guard<std::mutex> scoped_lock(config.m_graph_mutex);
+  return (config.m_graph_objects.find(obj) != config.m_graph_objects.end());
+}
+
+static dunedaq::dal::VariablesCache&
+get_variables_cache(const dunedaq::dal::Partition& p)
+{
+  return dunedaq::dal::AlgorithmUtils::get_variables_cache(p);
+}
+
+static std::string
+get_class_path(const dunedaq::dal::Partition& p, const std::vector<const dunedaq::dal::SW_Package*>& packages, const std::string& user_dir)
+{
+  return dunedaq::dal::AlgorithmUtils::get_class_path(p, packages, user_dir);
+}
+
+static void
+get_timeouts(const dunedaq::dal::SegConfig& seg_config, int& actionTimeout, int& shortActionTimeout)
+{
+  dunedaq::dal::AlgorithmUtils::get_timeouts(seg_config, actionTimeout, shortActionTimeout);
+}
+
+bool
+dunedaq::dal::is_dependency_graph_validated(const dunedaq::dal::Partition& p)
+{
+  return dunedaq::dal::AlgorithmUtils::is_graph_validated(p);
+}
+
+bool
+dunedaq::dal::is_dependency_graph_validated(const dunedaq::dal::Partition& p, const DalObject * obj)
+{
+  return dunedaq::dal::AlgorithmUtils::is_graph_validated(p, obj);
+}
+
+const dunedaq::dal::Segment *
+dunedaq::dal::Partition::get_segment(const std::string& name) const
+{
+  if (m_app_config.m_root_segment == nullptr)
+    {
+      std::lock_guard<std::mutex> scoped_lock(m_app_config.m_root_segment_mutex);
+
+      if (m_app_config.m_root_segment == nullptr)
+        {
+          DAL_INSTRUMENT_SCOPE(GetSegment);
+          DAL_INSTRUMENT_MISS(GetSegment);
+          DAL_TRACE_SPAN("get_segment", UID());
+
+          // release previous generation (if any) and start new one
+          m_app_config.__release_generation();
+          m_app_config.m_generation = std::make_shared<dunedaq::dal::ApplicationConfig::Generation>();
+
+          const dunedaq::dal::OnlineSegment * onlseg = get_OnlineInfrastructure();
+
+          dunedaq::dal::Segment * root_segment = const_cast<dunedaq::dal::Segment *>(const_cast<Configuration&>(p_db).get<dunedaq::dal::Segment>(const_cast<ConfigObject&>(onlseg->config_object()), onlseg->UID()));
+
+          // reinitialize seg config
+          dunedaq::dal::AlgorithmUtils::reset_seg_config(*root_segment, this);
+
+          root_segment->p_seg_config->m_base_segment = root_segment;
+
+          const dunedaq::dal::Computer * default_host = get_DefaultHost();
+
+          if (default_host && default_host->get_State() == false)
+            {
+              default_host = nullptr;
+            }
+
+          dunedaq::dal::SegmentsInclusion fuse;
+          fuse.reserve(get_Segments().size() * 4);
+          fuse.emplace(root_segment->UID(), std::string_view());
+
+          dunedaq::dal::AlgorithmUtils::add_segments(*root_segment, *this, get_Segments(), nullptr, default_host, fuse);
+
+          for (const auto& a : get_OnlineInfrastructureApplications())
+            {
+              if (const dunedaq::dal::ResourceBase * r = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceBase>(a))
+                {
+                  if (r->disabled(*this, true) == true)
+                    continue;
+                }
+
+              std::vector<const dunedaq::dal::BaseApplication *>& apps(dunedaq::dal::ClassMask::cast<dunedaq::dal::InfrastructureBase>(a) ? root_segment->get_seg_config(false)->m_infrastructure : root_segment->get_seg_config(false)->m_applications);
+              dunedaq::dal::AlgorithmUtils::add_normal_application(a, *root_segment, apps);
+            }
+
+          // FIXME 2022-06-02:
+          //   move check to get_all_applications() in next release tdaq-09-05-00
+          //   do it once per load/reload modifying ApplicationConfig
+
+          // compile image of the tree and check applications of enabled segments using it
+
+          dunedaq::dal::PartitionImage& image(m_app_config.m_generation->m_image);
+
+          dunedaq::dal::AlgorithmUtils::build_image(image, *root_segment);
+
+          check_duplicated_app_ids(image);
+
+          DAL_INSTRUMENT_OBJECTS(GetSegment, m_app_config.m_generation->m_segments.size() + m_app_config.m_generation->m_applications.size());
+
+          m_app_config.m_root_segment.store(root_segment);
+        }
+    }
+  else
+    {
+      DAL_INSTRUMENT_HIT(GetSegment);
+    }
+
+  const dunedaq::dal::Segment * seg = p_db.find<dunedaq::dal::Segment>(name);
+
+  if(seg == nullptr)
+    {
+      std::string::size_type idx = name.find(':');
+
+      if (idx != std::string::npos)
+        {
+          std::string seg_id = name.substr(0, idx);
+
+          seg = p_db.get<Segment>(seg_id);
+
+          if (seg == nullptr)
+            {
+              std::ostringstream text;
+              text << "cannot find template segment object \'" << seg_id << '\'';
+              throw dunedaq::dal::CannotFindSegmentByName(ERS_HERE, name, text.str());
+            }
+
+          if (const dunedaq::dal::TemplateSegment * ts = dunedaq::dal::ClassMask::cast<dunedaq::dal::TemplateSegment>(seg))
+            {
+              std::ostringstream text;
+              text << "template segment " << ts << " does not have rack \'" << name.substr(idx + 1) << '\'';
+              throw dunedaq::dal::CannotFindSegmentByName(ERS_HERE, name, text.str());
+            }
+          else
+            {
+              std::ostringstream text;
+              text << "object \'" << seg_id << "\' is not template segment";
+              throw dunedaq::dal::CannotFindSegmentByName(ERS_HERE, name, text.str());
+            }
+        }
+      else
+        {
+          throw dunedaq::dal::CannotFindSegmentByName(ERS_HERE, name, "no such non-template segment object");
+        }
+    }
+
+  return seg;
+}
+
+std::shared_ptr<const dunedaq::dal::PartitionImage>
+dunedaq::dal::Partition::get_image() const
+{
+  // the image is compiled together with the segments tree;
+  // repeat, if the tree was released by another thread before the generation is acquired
+
+  while (true)
+    {
+      get_segment(get_OnlineInfrastructure()->UID());
+
+      if (std::shared_ptr<ApplicationConfig::Generation> g = m_app_config.__get_generation())
+        return std::shared_ptr<const dunedaq::dal::PartitionImage>(g, &g->m_image);
+    }
+}
+
+const dunedaq::dal::AppConfig *
+dunedaq::dal::BaseApplication::get_app_config(bool no_except) const
 {
   const BaseApplication * ptr;
 
@@ -2062,7 +2727,7 @@ dunedaq::dal::BaseApplication::get_app_config(bool no_except) const
         throw dunedaq::dal::NotInitedByDalAlgorithm(ERS_HERE, UID(), class_name(), (void*)this, "BaseApplication::get_app_config()");
     }
 
-  return ptr->p_app_config.get();
+  return ptr->p_app_config;
 
 }
 
@@ -2112,7 +2777,7 @@ dunedaq::dal::Segment::get_seg_config(bool check_disabled, bool no_except) const
       throw(dunedaq::dal::SegmentDisabled(ERS_HERE));
     }
 
-  return ptr->p_seg_config.get();
+  return ptr->p_seg_config;
 
 }
 
@@ -2205,6 +2870,8 @@ dunedaq::dal::BaseApplication::get_shutdown_depends_from(const std::vector<const
 std::vector<const dunedaq::dal::BaseApplication *>
 dunedaq::dal::Segment::get_all_applications(std::set<std::string> * app_types, std::set<std::string> * segments, std::set<const dunedaq::dal::Computer *> * hosts) const
 {
+  DAL_TRACE_SPAN("get_all_applications", UID());
+
   // get all sub-types
   std::set<std::string> all_app_types;
 
@@ -2301,9 +2968,9 @@ get_some_info(const dunedaq::dal::BaseApplication * this_app, std::list<const du
 
           for (const auto& i : path)
             {
-              const dunedaq::dal::TemplateSegment * tseg = i->cast<dunedaq::dal::TemplateSegment>();
+              const dunedaq::dal::TemplateSegment * tseg = dunedaq::dal::ClassMask::cast<dunedaq::dal::TemplateSegment>(i);
 
-              if (const dunedaq::dal::Segment * seg = i->cast<dunedaq::dal::Segment>())
+              if (const dunedaq::dal::Segment * seg = dunedaq::dal::ClassMask::cast<dunedaq::dal::Segment>(i))
                 {
                   const ConfigObjectImpl * seg_config_obj_implementation(seg->config_object().implementation());
 
@@ -2457,9 +3124,160 @@ get_host_and_backup_list(const dunedaq::dal::BaseApplication * app)
   return s;
 }
 
+
+  // find layer of the source and move it to the end of the vector as the most recently used one; the caller holds the lock
+
+std::shared_ptr<const dunedaq::dal::AlgorithmUtils::EnvironmentLayer>
+dunedaq::dal::AlgorithmUtils::find_front_environment(ApplicationConfig::Generation& g, uint64_t id)
+{
+  auto& v(g.m_front_environment);
+
+  for (auto it = v.begin(); it != v.end(); ++it)
+    if (it->first == id)
+      {
+        std::rotate(it, it + 1, v.end());
+        return v.back().second;
+      }
+
+  return nullptr;
+}
+
+  // The environment defined by the partition attributes and by the segments on the path to the application
+  // does not depend on the application; it is built once per generation of the segments tree and shared.
+  // The partition attributes environment also depends on the process environment, so it is kept per source;
+  // only few recently used sources are kept, since Scope objects may create many short-lived ones.
+  // The layer is built out of the lock; if it was added by another thread meantime, that one is used.
+
+std::shared_ptr<const dunedaq::dal::AlgorithmUtils::EnvironmentLayer>
+dunedaq::dal::AlgorithmUtils::get_front_environment(const dunedaq::dal::Partition& p)
+{
+  const std::shared_ptr<ApplicationConfig::Generation> g(p.m_app_config.__get_generation());
+
+  const std::shared_ptr<const dunedaq::dal::EnvironmentSource> source(dunedaq::dal::EnvironmentSource::get());
+  const uint64_t id = source->get_id();
+
+  if (g)
+    {
+      std::lock_guard<std::mutex> scoped_lock(g->m_environment_mutex);
+
+      if (std::shared_ptr<const EnvironmentLayer> layer = find_front_environment(*g, id))
+        return layer;
+    }
+
+  Emap environment;
+
+  {
+    dunedaq::dal::EnvironmentSource::Scope scope(source);
+    add_front_partition_environment(environment, p); // throw
+  }
+
+  std::shared_ptr<const EnvironmentLayer> layer(std::make_shared<EnvironmentLayer>(environment.begin(), environment.end()));
+
+  if (g)
+    {
+      std::lock_guard<std::mutex> scoped_lock(g->m_environment_mutex);
+
+      if (std::shared_ptr<const EnvironmentLayer> x = find_front_environment(*g, id))
+        return x;
+
+      if (g->m_front_environment.size() >= static_cast<size_t>(ApplicationConfig::Generation::max_front_environments))
+        g->m_front_environment.erase(g->m_front_environment.begin());
+
+      g->m_front_environment.emplace_back(id, layer);
+    }
+
+  return layer;
+}
+
+std::shared_ptr<const dunedaq::dal::AlgorithmUtils::EnvironmentLayer>
+dunedaq::dal::AlgorithmUtils::get_segments_environment(const dunedaq::dal::BaseApplication * app, const dunedaq::dal::Partition& p, const std::list<const dunedaq::dal::Segment *>& s_list, const dunedaq::dal::Tag * tag)
+{
+  const std::shared_ptr<ApplicationConfig::Generation> g(p.m_app_config.__get_generation());
+
+  // the application's segment of the tree defines whole path
+  const ApplicationConfig::Generation::SegmentsEnvironment::key_type key(s_list.back(), tag);
+
+  if (g)
+    {
+      std::lock_guard<std::mutex> scoped_lock(g->m_environment_mutex);
+
+      auto it = g->m_segments_environment.find(key);
+
+      if (it != g->m_segments_environment.end())
+        {
+          DAL_INSTRUMENT_HIT(Environment);
+          return it->second;
+        }
+    }
+
+  DAL_INSTRUMENT_MISS(Environment);
+
+  dunedaq::dal::VariablesCache& cache(p.m_app_config.m_variables);
+
+  Emap layer;
+  std::map<std::string,std::string> parent_var_names;
+
+  for (std::list<const dunedaq::dal::Segment *>::const_reverse_iterator i = s_list.rbegin(); i != s_list.rend(); ++i) {
+      add_env_vars(layer, (*i)->get_ProcessEnvironment(), tag, &cache);
+
+      for(const auto& j : (*i)->get_infrastructure()) {
+        const dunedaq::dal::InfrastructureBase * ia = j->get_base_app()->cast<dunedaq::dal::InfrastructureBase>();
+        const std::string& swv_name(ia->get_SegmentProcEnvVarName());
+        if(!swv_name.empty()) {
+          try {
+              // add value of this segment-wide process environment variable
+            const std::string value = (
+              ia->get_SegmentProcEnvVarValue() == dunedaq::dal::InfrastructureBase::SegmentProcEnvVarValue::AppId ? j->UID() :
+              ia->get_SegmentProcEnvVarValue() == dunedaq::dal::InfrastructureBase::SegmentProcEnvVarValue::RunsOn ? j->get_host()->UID() :
+              get_host_and_backup_list(j)
+            );
+
+            TLOG_DEBUG(6) <<  j->get_base_app() << " adds segment-wide process environment " << swv_name << " => " << value ;
+            layer.emplace(swv_name, value);
+
+              // check if one is looking for parent with this name; add and mark if found
+            std::map<std::string,std::string>::iterator x = parent_var_names.find(swv_name);
+            if(x != parent_var_names.end() && !x->second.empty()) {
+              layer.emplace(x->second, value);
+              TLOG_DEBUG(6) <<  j->get_base_app() << " adds parent segment-wide process environment " << x->second << " => " << value ;
+              x->second = "";
+            }
+
+              // add to parent search list
+            const std::string& swv_parent_name(ia->get_SegmentProcEnvVarParentName());
+            if(!swv_parent_name.empty()) {
+              if(parent_var_names.emplace(swv_name,swv_parent_name).second == true) {
+                TLOG_DEBUG(6) <<  j->get_base_app() << " requires to add parent segment-wide process environment " << swv_parent_name << " (set for " << swv_name << ')' ;
+              }
+            }
+          }
+          catch(ers::Issue& ex) {
+            throw dunedaq::dal::BadApplicationInfo( ERS_HERE, app->UID(), "failed to build Application environment", ex ) ;
+          }
+        }
+      }
+
+      TLOG_DEBUG( 5) << "calculate " << app << " segments process environment:\n"
+                    "add " << *i << " object environment\n"
+                    << mk_app_env_string(layer) ;
+  }
+
+  std::shared_ptr<const EnvironmentLayer> result(std::make_shared<EnvironmentLayer>(layer.begin(), layer.end()));
+
+  if (g)
+    {
+      std::lock_guard<std::mutex> scoped_lock(g->m_environment_mutex);
+      return g->m_segments_environment.emplace(key, result).first->second;
+    }
+
+  return result;
+}
+
 const dunedaq::dal::Tag *
 dunedaq::dal::BaseApplication::get_info(std::map<std::string, std::string>& environment, std::vector<std::string>& program_names, std::string & startArgs, std::string & restartArgs) const
 {
+  DAL_TRACE_SPAN("get_info", UID());
+
   const dunedaq::dal::Tag * tag = nullptr;
   const dunedaq::dal::BaseApplication * base_app = get_base_app();
   const dunedaq::dal::ComputerProgram * program = base_app->get_Program();
@@ -2503,6 +3321,13 @@ dunedaq::dal::BaseApplication::get_info(std::map<std::string, std::string>& envi
 
   }
 
+  try {
+    resolve_program(program_names, *program);
+  }
+  catch(dunedaq::dal::NoProgramFile &ex) {
+    throw dunedaq::dal::BadApplicationInfo(ERS_HERE, UID(), "Failed to resolve program file.", ex);
+  }
+
   std::vector<std::string> search_paths;
   std::vector<std::string> paths_to_shared_libraries;
 
@@ -2526,7 +3351,7 @@ dunedaq::dal::BaseApplication::get_info(std::map<std::string, std::string>& envi
 
     // Append paths to shared libraries from application's repositories
     try {
-      dunedaq::dal::TestCircularDependency cd_fuse("application binary and library paths", this);
+      dunedaq::dal::TestCircularDependency cd_fuse("application binary and library paths", this, dunedaq::dal::is_dependency_graph_validated(partition));
       for (const auto& i : get_Uses()) {
         get_paths(i, search_paths, paths_to_shared_libraries, binary_info, cd_fuse);
       }
@@ -2560,69 +3385,35 @@ dunedaq::dal::BaseApplication::get_info(std::map<std::string, std::string>& envi
 
   try
   {
-    add_front_partition_environment(environment, partition); // throw
+    DAL_INSTRUMENT_SCOPE(Environment);
+    DAL_TRACE_SPAN("environment", UID());
+
+    const std::shared_ptr<const dunedaq::dal::AlgorithmUtils::EnvironmentLayer> front_environment(dunedaq::dal::AlgorithmUtils::get_front_environment(partition)); // throw
+    environment.insert(front_environment->begin(), front_environment->end());
     TLOG_DEBUG( 5) << "calculate " << this << " process environment:\n"
                   "add front " << &partition << " object environment\n"
                   << mk_app_env_string(environment) ;
 
+    dunedaq::dal::VariablesCache& cache(get_variables_cache(partition));
+
     // Application needs Environment
-    add_env_vars(environment, get_ProcessEnvironment(), tag);
+    add_env_vars(environment, get_ProcessEnvironment(), tag, &cache);
     TLOG_DEBUG( 5) << "calculate " << this << " process environment:\n"
                   "add " << this << " object environment\n"
                   << mk_app_env_string(environment) ;
 
     // Application's ComputerProgram needs Environment
-    add_env_vars(environment, program->get_ProcessEnvironment(), tag);
+    add_env_vars(environment, program->get_ProcessEnvironment(), tag, &cache);
     TLOG_DEBUG( 5) << "calculate " << this << " process environment:\n"
                   "add " << program << " object environment\n"
                   << mk_app_env_string(environment) ;
 
     // Segment list NeedsEnvironment
-    std::map<std::string,std::string> parent_var_names;
-    for (std::list<const dunedaq::dal::Segment *>::reverse_iterator i = s_list.rbegin(); i != s_list.rend(); ++i) {
-      add_env_vars(environment, (*i)->get_ProcessEnvironment(), tag);
-
-      for(const auto& j : (*i)->get_infrastructure()) {
-        const dunedaq::dal::InfrastructureBase * ia = j->get_base_app()->cast<dunedaq::dal::InfrastructureBase>();
-        const std::string& swv_name(ia->get_SegmentProcEnvVarName());
-        if(!swv_name.empty()) {
-          try {
-              // add value of this segment-wide process environment variable
-            const std::string value = (
-              ia->get_SegmentProcEnvVarValue() == dunedaq::dal::InfrastructureBase::SegmentProcEnvVarValue::AppId ? j->UID() :
-              ia->get_SegmentProcEnvVarValue() == dunedaq::dal::InfrastructureBase::SegmentProcEnvVarValue::RunsOn ? j->get_host()->UID() :
-              get_host_and_backup_list(j)
-            );
-
-            TLOG_DEBUG(6) <<  j->get_base_app() << " adds segment-wide process environment " << swv_name << " => " << value ;
-            environment.emplace(swv_name, value);
-
-              // check if one is looking for parent with this name; add and mark if found
-            std::map<std::string,std::string>::iterator x = parent_var_names.find(swv_name);
-            if(x != parent_var_names.end() && !x->second.empty()) {
-              environment.emplace(x->second, value);
-              TLOG_DEBUG(6) <<  j->get_base_app() << " adds parent segment-wide process environment " << x->second << " => " << value ;
-              x->second = "";
-            }
-
-              // add to parent search list
-            const std::string& swv_parent_name(ia->get_SegmentProcEnvVarParentName());
-            if(!swv_parent_name.empty()) {
-              if(parent_var_names.emplace(swv_name,swv_parent_name).second == true) {
-                TLOG_DEBUG(6) <<  j->get_base_app() << " requires to add parent segment-wide process environment " << swv_parent_name << " (set for " << swv_name << ')' ;
-              }
-            }
-          }
-          catch(ers::Issue& ex) {
-            throw dunedaq::dal::BadApplicationInfo( ERS_HERE, UID(), "failed to build Application environment", ex ) ;
-          }
-        }
-      }
-
-      TLOG_DEBUG( 5) << "calculate " << this << " process environment:\n"
-                    "add " << *i << " object environment\n"
-                    << mk_app_env_string(environment) ;
-    }
+    const std::shared_ptr<const dunedaq::dal::AlgorithmUtils::EnvironmentLayer> segments_environment(dunedaq::dal::AlgorithmUtils::get_segments_environment(this, partition, s_list, tag)); // throw
+    environment.insert(segments_environment->begin(), segments_environment->end());
+    TLOG_DEBUG( 5) << "calculate " << this << " process environment:\n"
+                  "add environment of " << s_list.size() << " segments\n"
+                  << mk_app_env_string(environment) ;
 
     add_end_partition_environment(environment, partition, base_app, program, tag);
     TLOG_DEBUG( 5) << "calculate " << base_app << " process environment:\n"
@@ -2644,7 +3435,7 @@ dunedaq::dal::BaseApplication::get_info(std::map<std::string, std::string>& envi
     // Add "PATH" and "LD_LIBRARY_PATH" variables
 
   set_path(environment, s_path_str, search_paths);
-  set_path(environment, s_ld_library_path_str, paths_to_shared_libraries);
+  set_library_path(environment, paths_to_shared_libraries, *tag);
 
   // Resolve the command line options
   static const std::string beg_env_str("env(");
@@ -2664,7 +3455,7 @@ dunedaq::dal::BaseApplication::get_info(std::map<std::string, std::string>& envi
 std::vector<const dunedaq::dal::Computer *>
 dunedaq::dal::AppConfig::get_backup_hosts() const
 {
-  if(const dunedaq::dal::Application * a = m_base_app->cast<dunedaq::dal::Application>())
+  if(const dunedaq::dal::Application * a = dunedaq::dal::ClassMask::cast<dunedaq::dal::Application>(m_base_app))
     {
       std::vector<const dunedaq::dal::Computer *> result;
       add_computers(result, a->get_BackupHosts());
@@ -2672,7 +3463,7 @@ dunedaq::dal::AppConfig::get_backup_hosts() const
     }
   else
     {
-      return m_template_backup_hosts;
+      return std::vector<const dunedaq::dal::Computer *>(m_template_backup_hosts.begin(), m_template_backup_hosts.end());
     }
 }
 
@@ -2683,7 +3474,7 @@ dunedaq::dal::BaseApplication::get_backup_hosts() const
 }
 
 dunedaq::dal::ApplicationConfig::ApplicationConfig(::Configuration& db) :
-    m_db(db), m_root_segment(nullptr)
+    m_db(db), m_root_segment(nullptr), m_graph_state(GraphNotValidated)
 {
   TLOG_DEBUG(2) <<  "construct the object " << (void *)this ;
   m_db.add_action(this);
@@ -2693,6 +3484,7 @@ dunedaq::dal::ApplicationConfig::~ApplicationConfig()
 {
   TLOG_DEBUG(2) <<  "destroy the object " << (void *)this ;
   m_db.remove_action(this);
+  __drop();
 }
 
 /******************************************************************************
@@ -2737,7 +3529,7 @@ add_vars(std::map<std::string, std::string>& cvt_map, const std::vector<const du
 {
   for (const auto& i : params)
     {
-      if (const dunedaq::dal::Variable * var = i->cast<dunedaq::dal::Variable>())
+      if (const dunedaq::dal::Variable * var = dunedaq::dal::ClassMask::cast<dunedaq::dal::Variable>(i))
         {
           const std::string& v = var->get_value(); // note, algorithm is used here; it returns empty value for multi-value variable
           cvt_map[var->get_Name()] = v;
@@ -2746,7 +3538,7 @@ add_vars(std::map<std::string, std::string>& cvt_map, const std::vector<const du
               const_cast<dunedaq::dal::Variable *>(var)->DalObject::unread();
             }
         }
-      else if (const dunedaq::dal::VariableSet * vars = i->cast<dunedaq::dal::VariableSet>())
+      else if (const dunedaq::dal::VariableSet * vars = dunedaq::dal::ClassMask::cast<dunedaq::dal::VariableSet>(i))
         {
           dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, vars);
           add_vars(cvt_map, vars->get_Contains(), cd_fuse);
@@ -2757,6 +3549,8 @@ add_vars(std::map<std::string, std::string>& cvt_map, const std::vector<const du
 void
 dunedaq::dal::SubstituteVariables::reset(const Partition& p)
 {
+  DAL_TRACE_SPAN("reset_variables", p.UID());
+
   m_cvt_map.clear();
 
   m_cvt_map[s_tdaq_partition_str] = p.UID();                      // insert name-of-partition parameter
@@ -2765,7 +3559,7 @@ dunedaq::dal::SubstituteVariables::reset(const Partition& p)
 
   try
     {
-      dunedaq::dal::TestCircularDependency cd_fuse("segments substitution parameters", &p);
+      dunedaq::dal::TestCircularDependency cd_fuse("segments substitution parameters", &p, dunedaq::dal::is_dependency_graph_validated(p));
       std::vector<const dunedaq::dal::Parameter*> params = p.get_Parameters();
 
       if (const dunedaq::dal::Segment* oseg = p.get_OnlineInfrastructure())
@@ -2866,6 +3660,8 @@ dunedaq::dal::SubstituteVariables::convert(std::string& s, const Configuration&,
 std::string
 dunedaq::dal::substitute_variables(const std::string& str_from, const std::map<std::string, std::string> * cvs_map, const std::string& beg, const std::string& end)
 {
+  DAL_INSTRUMENT_SCOPE(Substitution);
+
   std::string s(str_from);
 
   std::string::size_type pos = 0;       // position of tested string index
@@ -2875,6 +3671,8 @@ dunedaq::dal::substitute_variables(const std::string& str_from, const std::map<s
   int subst_count(1);
   const int max_subst(128);             // max allowed number of substitutions
 
+  std::shared_ptr<const dunedaq::dal::EnvironmentSource> source;  // used, if there is no conversion map
+
   while(
    ((p_start = s.find(beg, pos)) != std::string::npos) &&
    ((p_end = s.find(end, p_start + beg.size())) != std::string::npos)
@@ -2892,14 +3690,23 @@ dunedaq::dal::substitute_variables(const std::string& str_from, const std::map<s
     if(cvs_map) {
       std::map<std::string, std::string>::const_iterator j = cvs_map->find(var);
       if(j != cvs_map->end()) {
+        DAL_INSTRUMENT_HIT(Substitution);
         s.replace(p_start, p_end - p_start + end.size(), j->second);
       }
+      else {
+        DAL_INSTRUMENT_MISS(Substitution);
+      }
     }
     else {
-      if(char * env = getenv(var.c_str())) {
-        s.replace(p_start, p_end - p_start + end.size(), env);
+      if (!source)
+        source = dunedaq::dal::EnvironmentSource::get();
+
+      if(const std::string * env = source->find(var)) {
+        DAL_INSTRUMENT_HIT(Substitution);
+        s.replace(p_start, p_end - p_start + end.size(), *env);
       }
       else {
+        DAL_INSTRUMENT_MISS(Substitution);
         std::ostringstream text;
         text << "substitution failed for parameter \'" << std::string(s, p_start, p_end - p_start + end.size()) << '\'';
         throw dunedaq::oksdbinterfaces::Generic(ERS_HERE, text.str().c_str());
@@ -3046,6 +3853,11 @@ dunedaq::dal::get_partition(::Configuration& conf, const std::string& pname, uns
     {
       ers::error(dunedaq::dal::BadPartitionID(ERS_HERE, name));
     }
+  else
+    {
+      // validate objects graph once at load, so that the recursive algorithms can skip circular dependency fuses
+      dunedaq::dal::is_dependency_graph_validated(*p);
+    }
 
   return p;
 }
@@ -3054,18 +3866,37 @@ dunedaq::dal::get_partition(::Configuration& conf, const std::string& pname, uns
 ////////////////////////////////////////////////////////////////////////////////////
 
 
+  // The repositories used by the partition; each software package, program and application is processed once.
+  // A package is marked as visited after its Uses relationship is processed, so a circular dependency still
+  // reaches the fuse, if the objects graph was not validated.
+
+struct UsedRepositories
+{
+  std::set<const dunedaq::dal::SW_Repository *> m_repositories;
+  std::unordered_set<const dunedaq::dal::SW_Package *> m_packages;
+  std::unordered_set<const dunedaq::dal::ComputerProgram *> m_programs;
+  std::unordered_set<const dunedaq::dal::BaseApplication *> m_applications;
+  bool m_failed = false;
+};
+
+
   // add vector of repository objects to the set of repositories
 
 static void
-add_repositories(std::set<const dunedaq::dal::SW_Repository *>& repositories, const std::vector<const dunedaq::dal::SW_Package*>& reps, dunedaq::dal::TestCircularDependency& cd_fuse)
+add_repositories(UsedRepositories& used, const std::vector<const dunedaq::dal::SW_Package*>& reps, dunedaq::dal::TestCircularDependency& cd_fuse)
 {
   for (const auto& i : reps)
     {
-      if (const dunedaq::dal::SW_Repository * r = i->cast<dunedaq::dal::SW_Repository>())
-        repositories.insert(r);
+      if (used.m_packages.find(i) != used.m_packages.end())
+        continue;
+
+      if (const dunedaq::dal::SW_Repository * r = dunedaq::dal::ClassMask::cast<dunedaq::dal::SW_Repository>(i))
+        used.m_repositories.insert(r);
 
       dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, i);
-      add_repositories(repositories, i->get_Uses(), cd_fuse);
+      add_repositories(used, i->get_Uses(), cd_fuse);
+
+      used.m_packages.insert(i);
     }
 }
 
@@ -3073,31 +3904,38 @@ add_repositories(std::set<const dunedaq::dal::SW_Repository *>& repositories, co
   // process repositories linked with application
 
 static void
-process_application(std::set<const dunedaq::dal::SW_Repository *>& repositories, const dunedaq::dal::BaseApplication * a)
+process_application(UsedRepositories& used, const dunedaq::dal::BaseApplication * a, bool validated)
 {
-  if (a)
+  if (a && used.m_applications.find(a) == used.m_applications.end())
     {
       try
         {
-          dunedaq::dal::TestCircularDependency cd_fuse("used repositories", a);
+          dunedaq::dal::TestCircularDependency cd_fuse("used repositories", a, validated);
 
           // add repositories used by application
-          add_repositories(repositories, a->get_Uses(), cd_fuse);
+          add_repositories(used, a->get_Uses(), cd_fuse);
 
           // add repositories linked with the application's program
           if (const dunedaq::dal::ComputerProgram * p = a->get_Program())
             {
-              if (const dunedaq::dal::SW_Repository * r = p->get_BelongsTo())
-                repositories.insert(r);
+              if (used.m_programs.find(p) == used.m_programs.end())
+                {
+                  if (const dunedaq::dal::SW_Repository * r = p->get_BelongsTo())
+                    used.m_repositories.insert(r);
+
+                  dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, p);
+                  add_repositories(used, p->get_Uses(), cd_fuse);
 
-              dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, p);
-              add_repositories(repositories, p->get_Uses(), cd_fuse);
+                  used.m_programs.insert(p);
+                }
             }
 
+          used.m_applications.insert(a);
         }
       catch (ers::Issue& ex)
         {
           ers::error(dunedaq::dal::BadApplicationInfo(ERS_HERE,a->UID(),"db problem",ex));
+          used.m_failed = true;
         }
     }
 }
@@ -3106,55 +3944,82 @@ process_application(std::set<const dunedaq::dal::SW_Repository *>& repositories,
   // process applications of segment
 
 static void
-process_segment(std::set<const dunedaq::dal::SW_Repository *>& repositories, const dunedaq::dal::Segment& s, dunedaq::dal::TestCircularDependency& cd_fuse)
+process_segment(UsedRepositories& used, const dunedaq::dal::Segment& s, dunedaq::dal::TestCircularDependency& cd_fuse)
 {
   // check segment's controller
-  process_application(repositories, s.get_IsControlledBy()->cast<dunedaq::dal::BaseApplication>());
+  process_application(used, s.get_IsControlledBy()->cast<dunedaq::dal::BaseApplication>(), cd_fuse.is_validated());
 
   // check segment's applications, which are not resources
   for (const auto & i : s.get_Applications())
-    process_application(repositories, i);
+    process_application(used, i, cd_fuse.is_validated());
 
   // check segment's infrastructure applications
   for (const auto& i : s.get_Infrastructure())
-    process_application(repositories, i->cast<dunedaq::dal::BaseApplication>());
+    process_application(used, dunedaq::dal::ClassMask::cast<dunedaq::dal::BaseApplication>(i), cd_fuse.is_validated());
 
   // add segment's resource applications
   for (const auto& i : s.get_Resources())
     for (const auto& j : get_resource_applications(i))
-      process_application(repositories, j);
+      process_application(used, j, cd_fuse.is_validated());
 
   // process applications from nested segments
   for (const auto& i : s.get_Segments())
     {
       dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, i);
-      process_segment(repositories, *i, cd_fuse);
+      process_segment(used, *i, cd_fuse);
     }
 }
 
 std::set<const dunedaq::dal::SW_Repository *>
-dunedaq::dal::get_used_repositories(const dunedaq::dal::Partition& p)
+dunedaq::dal::AlgorithmUtils::get_used_repositories(const dunedaq::dal::Partition& p)
 {
-  std::set<const dunedaq::dal::SW_Repository *> repositories;
+  const ApplicationConfig& config(p.m_app_config);
 
-  dunedaq::dal::TestCircularDependency cd_fuse("used segments and repositories", &p);
+  {
+    std::lock_guard<std::mutex> scoped_lock(config.m_repositories_mutex);
+
+    if (config.m_used_repositories)
+      return *config.m_used_repositories;
+  }
+
+  DAL_TRACE_SPAN("get_used_repositories", p.UID());
+
+  UsedRepositories used;
+
+  dunedaq::dal::TestCircularDependency cd_fuse("used segments and repositories", &p, dunedaq::dal::is_dependency_graph_validated(p));
 
   if (const dunedaq::dal::OnlineSegment * online_segment = p.get_OnlineInfrastructure())
     {
       dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, online_segment);
-      process_segment(repositories, *online_segment, cd_fuse);
+      process_segment(used, *online_segment, cd_fuse);
 
       for (const auto &a : p.get_OnlineInfrastructureApplications())
-        process_application(repositories, a);
+        process_application(used, a, cd_fuse.is_validated());
     }
 
   for (const auto& i : p.get_Segments())
     {
       dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, i);
-      process_segment(repositories, *i, cd_fuse);
+      process_segment(used, *i, cd_fuse);
+    }
+
+  // do not cache incomplete result, so the problems are reported again by next call
+
+  if (used.m_failed == false)
+    {
+      std::lock_guard<std::mutex> scoped_lock(config.m_repositories_mutex);
+
+      if (!config.m_used_repositories)
+        config.m_used_repositories = std::make_unique<const std::set<const dunedaq::dal::SW_Repository *>>(used.m_repositories);
     }
 
-  return repositories;
+  return std::move(used.m_repositories);
+}
+
+std::set<const dunedaq::dal::SW_Repository *>
+dunedaq::dal::get_used_repositories(const dunedaq::dal::Partition& p)
+{
+  return dunedaq::dal::AlgorithmUtils::get_used_repositories(p);
 }
 
 static void
@@ -3162,15 +4027,18 @@ check_file_exists(const std::string& path, std::string & file)
 {
   TLOG_DEBUG(6) <<  "try path \'" << path << '\'' ;
 
-  struct stat buffer;
-  if (stat(path.c_str(), &buffer) == 0)
+  if (dunedaq::dal::FileSystemProbe::exists(path))
     file = path;
 }
 
 
-void
-dunedaq::dal::add_classpath(const dunedaq::dal::SW_Repository& rep, const std::string& user_dir, std::string& class_path)
+  // returns false, if a JAR file was not found
+
+static bool
+add_jar_files(const dunedaq::dal::SW_Repository& rep, const std::string& user_dir, std::string& class_path)
 {
+  bool found_all = true;
+
   for (const auto& j : rep.get_SW_Objects())
     {
       if (const dunedaq::dal::JarFile *jf = j->cast<dunedaq::dal::JarFile>())
@@ -3197,15 +4065,83 @@ dunedaq::dal::add_classpath(const dunedaq::dal::SW_Repository& rep, const std::s
           if (file.empty())
             {
               ers::error(dunedaq::dal::NoJarFile(ERS_HERE, bn, j->UID(), j->class_name(), rep.UID(), rep.class_name()));
+              found_all = false;
             }
           else
             {
+              DAL_INSTRUMENT_OBJECTS(AddClasspath, 1);
+
               if (!class_path.empty())
                 class_path.push_back(':');
               class_path.append(file);
             }
         }
     }
+
+  return found_all;
+}
+
+
+void
+dunedaq::dal::add_classpath(const dunedaq::dal::SW_Repository& rep, const std::string& user_dir, std::string& class_path)
+{
+  DAL_INSTRUMENT_SCOPE(AddClasspath);
+
+  add_jar_files(rep, user_dir, class_path);
+}
+
+
+  // The JARs of the repositories used by Java application; the result is cached per repositories and
+  // repository root and is recalculated, if a directory listing used by the FileSystemProbe was changed.
+  // The result is not cached, if a JAR file was not found, so the problem is reported for every application.
+
+std::string
+dunedaq::dal::AlgorithmUtils::get_class_path(const dunedaq::dal::Partition& p, const std::vector<const dunedaq::dal::SW_Package*>& packages, const std::string& user_dir)
+{
+  DAL_INSTRUMENT_SCOPE(AddClasspath);
+
+  const ApplicationConfig& config(p.m_app_config);
+
+  std::string key(user_dir);
+
+  for (const auto &j : packages)
+    if (dunedaq::dal::ClassMask::castable<dunedaq::dal::SW_Repository>(j))
+      {
+        key.push_back('\0');
+        key.append(j->UID());
+      }
+
+  const uint64_t version = dunedaq::dal::FileSystemProbe::get_version();
+
+  {
+    std::lock_guard<std::mutex> scoped_lock(config.m_repositories_mutex);
+
+    auto it = config.m_class_paths.find(key);
+
+    if (it != config.m_class_paths.end() && it->second.first == version)
+      {
+        DAL_INSTRUMENT_HIT(AddClasspath);
+        return it->second.second;
+      }
+  }
+
+  DAL_INSTRUMENT_MISS(AddClasspath);
+
+  std::string class_path;
+  bool found_all = true;
+
+  for (const auto &j : packages)
+    if (const dunedaq::dal::SW_Repository *rep = dunedaq::dal::ClassMask::cast<dunedaq::dal::SW_Repository>(j))
+      if (add_jar_files(*rep, user_dir, class_path) == false)
+        found_all = false;
+
+  if (found_all)
+    {
+      std::lock_guard<std::mutex> scoped_lock(config.m_repositories_mutex);
+      config.m_class_paths[key] = std::make_pair(version, class_path);
+    }
+
+  return class_path;
 }
 
 /******************************************************************************
@@ -0,0 +1,647 @@
+//
+//  FILE: dal/src/app-info-cache.cpp
+//
+//  Contains implementation of persistent cache of application launch information.
+//
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "ers/ers.hpp"
+#include "logging/Logging.hpp"
+
+#include "dal/BaseApplication.hpp"
+#include "dal/Binary.hpp"
+#include "dal/BinaryFile.hpp"
+#include "dal/Computer.hpp"
+#include "dal/ComputerProgram.hpp"
+#include "dal/OnlineSegment.hpp"
+#include "dal/Parameter.hpp"
+#include "dal/Partition.hpp"
+#include "dal/PlatformCompatibility.hpp"
+#include "dal/SW_ExternalPackage.hpp"
+#include "dal/SW_Package.hpp"
+#include "dal/SW_PackageVariable.hpp"
+#include "dal/SW_Repository.hpp"
+#include "dal/Script.hpp"
+#include "dal/Segment.hpp"
+#include "dal/Tag.hpp"
+#include "dal/TagMapping.hpp"
+#include "dal/Variable.hpp"
+#include "dal/VariableSet.hpp"
+
+#include "dal/app-info-cache.hpp"
+#include "dal/environment-source.hpp"
+#include "dal/launch-options.hpp"
+#include "dal/partition-image.hpp"
+#include "dal/util.hpp"
+
+
+using namespace dunedaq::oksdbinterfaces;
+
+
+namespace {
+
+    // version of key calculation and entry format; increase on any change
+
+  const char s_format[] = "dal-app-info-1";
+
+    // process environment read by add_front_partition_environment()
+
+  const char * s_env_inputs[] = { "TDAQ_DB_REPOSITORY", "TDAQ_DB_USER_REPOSITORY", "OKS_REPOSITORY_MAPPING_DIR" };
+
+
+    // 128-bit hash made of two 64-bit FNV-1a like hashes with different bases and multipliers
+
+  class Hash
+  {
+  public:
+
+    void
+    add(const char * data, size_t len)
+    {
+      for (size_t i = 0; i < len; ++i)
+        {
+          const uint8_t c = static_cast<uint8_t>(data[i]);
+          m_h1 = (m_h1 ^ c) * 0x100000001b3ULL;
+          m_h2 = (m_h2 ^ c) * 0x9e3779b97f4a7c15ULL;
+        }
+    }
+
+    void
+    add(uint64_t value)
+    {
+      add(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+      // add length first, so concatenated strings are not ambiguous
+
+    void
+    add(const std::string& s)
+    {
+      add(static_cast<uint64_t>(s.size()));
+      add(s.data(), s.size());
+    }
+
+    uint64_t
+    get64() const
+    {
+      return m_h1 ^ (m_h2 >> 1);
+    }
+
+    std::string
+    str() const
+    {
+      char buf[33];
+      snprintf(buf, sizeof(buf), "%016lx%016lx", static_cast<unsigned long>(m_h1), static_cast<unsigned long>(m_h2));
+      return buf;
+    }
+
+  private:
+
+    uint64_t m_h1 = 0xcbf29ce484222325ULL;
+    uint64_t m_h2 = 0x84222325cbf29ce4ULL;
+  };
+
+
+    // add names of variables referenced as $(NAME) to the set
+
+  void
+  add_env_refs(const std::string& value, std::set<std::string>& names)
+  {
+    std::string::size_type p = 0;
+
+    while ((p = value.find("$(", p)) != std::string::npos)
+      {
+        std::string::size_type end = value.find(')', p + 2);
+
+        if (end == std::string::npos)
+          break;
+
+        names.emplace(value, p + 2, end - p - 2);
+        p = end + 1;
+      }
+  }
+
+
+    // the database objects the get_info() result depends on, ordered by full name
+
+  struct Dependencies
+  {
+    std::map<std::string, const DalObject *> m_objects;
+
+    bool
+    add(const DalObject * obj)
+    {
+      if (obj == nullptr)
+        return false;
+
+      std::string name(obj->UID());
+      name.push_back('@');
+      name.append(obj->class_name());
+
+      return m_objects.emplace(std::move(name), obj).second;
+    }
+
+    void
+    add(const dunedaq::dal::Tag * tag)
+    {
+      add(static_cast<const DalObject *>(tag));
+    }
+
+    void
+    add(const std::vector<const dunedaq::dal::Tag *>& tags)
+    {
+      for (const auto& x : tags)
+        add(x);
+    }
+
+    void
+    add(const std::vector<const dunedaq::dal::Parameter *>& params)
+    {
+      for (const auto& x : params)
+        if (add(static_cast<const DalObject *>(x)))
+          {
+            if (const dunedaq::dal::Variable * v = x->cast<dunedaq::dal::Variable>())
+              {
+                for (const auto& m : v->get_TagValues())
+                  add(static_cast<const DalObject *>(m));
+              }
+            else if (const dunedaq::dal::VariableSet * s = x->cast<dunedaq::dal::VariableSet>())
+              {
+                add(s->get_Contains());
+              }
+          }
+    }
+
+    void
+    add(const std::vector<const dunedaq::dal::SW_Package *>& packages)
+    {
+      for (const auto& x : packages)
+        add(x);
+    }
+
+    void
+    add(const dunedaq::dal::SW_Package * p)
+    {
+      if (add(static_cast<const DalObject *>(p)))
+        {
+          add(p->get_ProcessEnvironment());
+
+          for (const auto& v : p->get_AddProcessEnvironment())
+            add(static_cast<const DalObject *>(v));
+
+          if (const dunedaq::dal::SW_Repository * r = p->cast<dunedaq::dal::SW_Repository>())
+            {
+              add(r->get_Tags());
+            }
+          else if (const dunedaq::dal::SW_ExternalPackage * e = p->cast<dunedaq::dal::SW_ExternalPackage>())
+            {
+              for (const auto& m : e->get_Binaries())
+                add(static_cast<const DalObject *>(m));
+
+              for (const auto& m : e->get_SharedLibraries())
+                add(static_cast<const DalObject *>(m));
+            }
+
+          add(p->get_Uses());
+        }
+    }
+
+    void
+    add(const dunedaq::dal::ComputerProgram * p)
+    {
+      if (add(static_cast<const DalObject *>(p)))
+        {
+          add(p->get_ProcessEnvironment());
+          add(p->get_BelongsTo()->cast<dunedaq::dal::SW_Package>());
+          add(p->get_Uses());
+
+          if (const dunedaq::dal::Binary * b = p->cast<dunedaq::dal::Binary>())
+            for (const auto& f : b->get_ExactImplementations())
+              {
+                add(static_cast<const DalObject *>(f));
+                add(f->get_Tag());
+              }
+        }
+    }
+
+    void
+    add(const dunedaq::dal::PlatformCompatibility * p)
+    {
+      if (add(static_cast<const DalObject *>(p)))
+        for (const auto& x : p->get_CompatibleWith())
+          add(x);
+    }
+  };
+
+} // namespace
+
+
+dunedaq::dal::AppInfoCache::AppInfoCache(Configuration& db, const std::string& dir, const std::string& context) :
+  m_db(db),
+  m_dir(dir),
+  m_context(context),
+  m_hits(0),
+  m_misses(0)
+{
+  if (mkdir(m_dir.c_str(), 0777) != 0 && errno != EEXIST)
+    throw dunedaq::dal::BadAppInfoCache(ERS_HERE, m_dir, std::string("cannot create directory: ") + strerror(errno));
+
+  TLOG_DEBUG(2) << "construct the object " << (void *)this << " using directory " << m_dir;
+  m_db.add_action(this);
+}
+
+dunedaq::dal::AppInfoCache::~AppInfoCache()
+{
+  TLOG_DEBUG(2) << "destroy the object " << (void *)this << " (hits: " << m_hits << ", misses: " << m_misses << ')';
+  m_db.remove_action(this);
+}
+
+
+std::string
+dunedaq::dal::AppInfoCache::get_key(const dunedaq::dal::BaseApplication& app)
+{
+  const dunedaq::dal::Segment * segment = app.get_segment();
+  const dunedaq::dal::Partition& partition(*segment->get_seg_config(false)->get_partition());
+  const dunedaq::dal::BaseApplication * base_app = app.get_base_app();
+
+  Hash h;
+  Dependencies deps;
+  std::set<std::string> env_refs;
+
+  h.add(std::string(s_format));
+  h.add(m_context);
+
+  // application identity and host
+
+  h.add(app.UID());
+  h.add(app.class_name());
+  h.add(app.get_host()->UID());
+
+  deps.add(static_cast<const DalObject *>(base_app));
+  deps.add(static_cast<const DalObject *>(app.get_host()));
+  deps.add(base_app->get_ProcessEnvironment());
+  deps.add(base_app->get_ExplicitTag());
+  deps.add(base_app->get_Uses());
+  deps.add(base_app->get_Program());
+
+  // partition and online segment
+
+  deps.add(static_cast<const DalObject *>(&partition));
+  deps.add(partition.get_ProcessEnvironment());
+  deps.add(partition.get_Parameters());
+  deps.add(partition.get_DefaultTags());
+
+  if (const dunedaq::dal::OnlineSegment * onlseg = partition.get_OnlineInfrastructure())
+    {
+      deps.add(static_cast<const DalObject *>(onlseg));
+
+      for (const auto& x : onlseg->get_CompatibilityInfo())
+        deps.add(x);
+    }
+
+  // segments path from the root segment to the application and their infrastructure applications
+
+    {
+      const std::shared_ptr<const dunedaq::dal::PartitionImage> image_ptr(partition.get_image()); // keeps the image arrays alive on reload
+      const dunedaq::dal::PartitionImage& image(*image_ptr);
+      const auto& segments(image.get_segments());
+
+      // the segment is indexed by the image of its generation; check it, since the tree may be regenerated meantime
+
+      uint32_t idx = segment->get_seg_config(false)->get_image_idx();
+
+      if (idx >= segments.size() || segments[idx] != segment)
+        throw dunedaq::dal::BadApplicationInfo(ERS_HERE, app.UID(), "the application is not in the partition control tree");
+
+      std::vector<const dunedaq::dal::Segment *> path;
+
+      for (; idx != PartitionImage::npos; idx = image.get_segment_parents()[idx])
+        path.push_back(segments[idx]);
+
+      for (auto i = path.rbegin(); i != path.rend(); ++i)
+        {
+          const dunedaq::dal::Segment * s = *i;
+
+          h.add(s->UID());
+
+          deps.add(static_cast<const DalObject *>(s->get_base_segment()));
+          deps.add(s->get_base_segment()->get_ProcessEnvironment());
+          deps.add(s->get_base_segment()->get_DefaultTags());
+
+          for (const auto& j : s->get_infrastructure())
+            {
+              h.add(j->UID());
+              h.add(j->get_host()->UID());
+
+              for (const auto& x : j->get_backup_hosts())
+                h.add(x->UID());
+
+              deps.add(static_cast<const DalObject *>(j->get_base_app()));
+            }
+        }
+    }
+
+  // process environment
+
+  const std::shared_ptr<const dunedaq::dal::EnvironmentSource> source(dunedaq::dal::EnvironmentSource::get());
+
+  for (const auto& name : s_env_inputs)
+    if (const std::string * value = source->find(name))
+      {
+        h.add(*value);
+        add_env_refs(*value, env_refs);
+      }
+    else
+      {
+        h.add(static_cast<uint64_t>(-1));
+      }
+
+  // contents of database objects
+
+    {
+      std::lock_guard<std::mutex> scoped_lock(m_mutex);
+
+      for (const auto& x : deps.m_objects)
+        {
+          auto it = m_objects.find(x.second);
+
+          if (it == m_objects.end())
+            {
+              std::ostringstream s;
+              x.second->print(0, true, s);
+
+              const std::string text(s.str());
+
+              Hash oh;
+              oh.add(text);
+
+              ObjectInfo info;
+              info.m_hash = oh.get64();
+              add_env_refs(text, info.m_env_refs);
+
+              it = m_objects.emplace(x.second, std::move(info)).first;
+            }
+
+          h.add(x.first);
+          h.add(it->second.m_hash);
+          env_refs.insert(it->second.m_env_refs.begin(), it->second.m_env_refs.end());
+        }
+    }
+
+  // process environment referenced by the database parameters
+
+  for (const auto& name : env_refs)
+    {
+      h.add(name);
+
+      if (const std::string * value = source->find(name))
+        h.add(*value);
+      else
+        h.add(static_cast<uint64_t>(-1));
+    }
+
+  return h.str();
+}
+
+
+std::string
+dunedaq::dal::AppInfoCache::get_file_name(const std::string& key, bool make_dir) const
+{
+  // use first two characters of the key as sub-directory to keep directories small
+
+  std::string name(m_dir);
+  name.push_back('/');
+  name.append(key, 0, 2);
+
+  if (make_dir && mkdir(name.c_str(), 0777) != 0 && errno != EEXIST)
+    throw dunedaq::dal::BadAppInfoCache(ERS_HERE, m_dir, std::string("cannot create directory \'") + name + "\': " + strerror(errno));
+
+  name.push_back('/');
+  name.append(key);
+
+  return name;
+}
+
+
+namespace {
+
+  void
+  write_string(std::ostream& s, const std::string& value)
+  {
+    const uint32_t len = value.size();
+    s.write(reinterpret_cast<const char *>(&len), sizeof(len));
+    s.write(value.data(), len);
+  }
+
+  bool
+  read_string(std::istream& s, std::string& value)
+  {
+    uint32_t len;
+
+    if (!s.read(reinterpret_cast<char *>(&len), sizeof(len)))
+      return false;
+
+    value.resize(len);
+
+    return static_cast<bool>(s.read(&value[0], len));
+  }
+
+  bool
+  read_entry(std::istream& s, std::map<std::string, std::string>& environment, std::vector<std::string>& program_names, std::string& startArgs, std::string& restartArgs, std::string& tag)
+  {
+    std::string name, value;
+    uint32_t num;
+
+    if (!read_string(s, tag) || !read_string(s, startArgs) || !read_string(s, restartArgs))
+      return false;
+
+    if (!s.read(reinterpret_cast<char *>(&num), sizeof(num)))
+      return false;
+
+    program_names.clear();
+
+    for (uint32_t i = 0; i < num; ++i)
+      {
+        if (!read_string(s, value))
+          return false;
+
+        program_names.push_back(value);
+      }
+
+    if (!s.read(reinterpret_cast<char *>(&num), sizeof(num)))
+      return false;
+
+    environment.clear();
+
+    for (uint32_t i = 0; i < num; ++i)
+      {
+        if (!read_string(s, name) || !read_string(s, value))
+          return false;
+
+        environment.emplace_hint(environment.end(), name, value);
+      }
+
+    return true;
+  }
+
+} // namespace
+
+
+bool
+dunedaq::dal::AppInfoCache::read(const std::string& key, std::map<std::string, std::string>& environment, std::vector<std::string>& program_names, std::string& startArgs, std::string& restartArgs, std::string& tag)
+{
+  const std::string file_name(get_file_name(key, false));
+
+  std::ifstream f(file_name, std::ios::binary);
+
+  if (!f)
+    return false;
+
+  std::string format, stored_key;
+
+  if (!read_string(f, format) || format != s_format || !read_string(f, stored_key) || stored_key != key)
+    throw dunedaq::dal::BadAppInfoCache(ERS_HERE, m_dir, std::string("file \'") + file_name + "\' has bad header");
+
+  // read into local variables, so the output parameters are not modified in case of problems
+
+  std::map<std::string, std::string> env;
+  std::vector<std::string> names;
+  std::string start_args, restart_args, tag_id;
+
+  if (!read_entry(f, env, names, start_args, restart_args, tag_id))
+    throw dunedaq::dal::BadAppInfoCache(ERS_HERE, m_dir, std::string("file \'") + file_name + "\' is truncated");
+
+  environment.swap(env);
+  program_names.swap(names);
+  startArgs.swap(start_args);
+  restartArgs.swap(restart_args);
+  tag.swap(tag_id);
+
+  return true;
+}
+
+
+void
+dunedaq::dal::AppInfoCache::write(const std::string& key, const std::map<std::string, std::string>& environment, const std::vector<std::string>& program_names, const std::string& startArgs, const std::string& restartArgs, const std::string& tag)
+{
+  const std::string file_name(get_file_name(key, true));
+
+  std::ostringstream tmp_name;
+  tmp_name << file_name << ".tmp." << getpid() << '.' << std::this_thread::get_id();
+
+    {
+      std::ofstream f(tmp_name.str(), std::ios::binary | std::ios::trunc);
+
+      if (!f)
+        throw dunedaq::dal::BadAppInfoCache(ERS_HERE, m_dir, std::string("cannot open file \'") + tmp_name.str() + "\' for writing: " + strerror(errno));
+
+      write_string(f, s_format);
+      write_string(f, key);
+      write_string(f, tag);
+      write_string(f, startArgs);
+      write_string(f, restartArgs);
+
+      uint32_t num = program_names.size();
+      f.write(reinterpret_cast<const char *>(&num), sizeof(num));
+
+      for (const auto& x : program_names)
+        write_string(f, x);
+
+      num = environment.size();
+      f.write(reinterpret_cast<const char *>(&num), sizeof(num));
+
+      for (const auto& x : environment)
+        {
+          write_string(f, x.first);
+          write_string(f, x.second);
+        }
+
+      f.close();
+
+      if (!f)
+        {
+          unlink(tmp_name.str().c_str());
+          throw dunedaq::dal::BadAppInfoCache(ERS_HERE, m_dir, std::string("failed to write file \'") + tmp_name.str() + '\'');
+        }
+    }
+
+  if (rename(tmp_name.str().c_str(), file_name.c_str()) != 0)
+    {
+      const int error = errno;
+      unlink(tmp_name.str().c_str());
+      throw dunedaq::dal::BadAppInfoCache(ERS_HERE, m_dir, std::string("cannot rename file \'") + tmp_name.str() + "\': " + strerror(error));
+    }
+}
+
+
+const dunedaq::dal::Tag *
+dunedaq::dal::AppInfoCache::get_info(const dunedaq::dal::BaseApplication& app, std::map<std::string, std::string>& environment, std::vector<std::string>& program_names, std::string& startArgs, std::string& restartArgs)
+{
+  // the CLASSPATH of Java scripts depends on presence of jar files, do not cache them
+
+  if (const dunedaq::dal::Script * script = app.get_base_app()->get_Program()->cast<dunedaq::dal::Script>())
+    if (!strcasecmp("java", script->get_Shell().c_str()))
+      {
+        m_misses++;
+        return app.get_info(environment, program_names, startArgs, restartArgs);
+      }
+
+  // the launch options test the file system too
+
+  if (dunedaq::dal::LaunchOptions::is_any_set())
+    {
+      m_misses++;
+      return app.get_info(environment, program_names, startArgs, restartArgs);
+    }
+
+  const std::string key(get_key(app));
+
+  try
+    {
+      std::string tag_id;
+
+      if (read(key, environment, program_names, startArgs, restartArgs, tag_id))
+        {
+          if (const dunedaq::dal::Tag * tag = m_db.get<dunedaq::dal::Tag>(tag_id))
+            {
+              m_hits++;
+              TLOG_DEBUG(3) << "read info of application " << app.UID() << " from cache entry " << key;
+              return tag;
+            }
+        }
+    }
+  catch (ers::Issue& ex)
+    {
+      ers::warning(ex);
+    }
+
+  m_misses++;
+
+  const dunedaq::dal::Tag * tag = app.get_info(environment, program_names, startArgs, restartArgs);
+
+  try
+    {
+      write(key, environment, program_names, startArgs, restartArgs, tag->UID());
+      TLOG_DEBUG(3) << "write info of application " << app.UID() << " to cache entry " << key;
+    }
+  catch (ers::Issue& ex)
+    {
+      ers::warning(ex);
+    }
+
+  return tag;
+}
@@ -0,0 +1,126 @@
+//
+//  FILE: dal/src/class-mask.cpp
+//
+//  Contains implementation of the masks of DAL classes used for fast type tests.
+//
+
+#include <mutex>
+#include <unordered_map>
+
+#include "logging/Logging.hpp"
+
+#include "dal/Application.hpp"
+#include "dal/BaseApplication.hpp"
+#include "dal/Component.hpp"
+#include "dal/Computer.hpp"
+#include "dal/ComputerSet.hpp"
+#include "dal/InfrastructureApplication.hpp"
+#include "dal/InfrastructureBase.hpp"
+#include "dal/Parameter.hpp"
+#include "dal/Resource.hpp"
+#include "dal/ResourceBase.hpp"
+#include "dal/ResourceSet.hpp"
+#include "dal/ResourceSetAND.hpp"
+#include "dal/ResourceSetOR.hpp"
+#include "dal/RunControlApplicationBase.hpp"
+#include "dal/SW_ExternalPackage.hpp"
+#include "dal/SW_Package.hpp"
+#include "dal/SW_Repository.hpp"
+#include "dal/Segment.hpp"
+#include "dal/TemplateApplication.hpp"
+#include "dal/TemplateSegment.hpp"
+#include "dal/Variable.hpp"
+#include "dal/VariableSet.hpp"
+
+#include "dal/class-mask.hpp"
+
+
+std::atomic<uint32_t> dunedaq::dal::ClassMask::s_generation(1);   // zero-initialized cache entries are invalid
+thread_local dunedaq::dal::ClassMask::Entry dunedaq::dal::ClassMask::s_cache[cache_size];
+
+
+namespace {
+
+  // the order of names corresponds to ClassMask::Class enumeration
+
+  const std::string *
+  get_name(dunedaq::dal::ClassMask::Class c)
+  {
+    static const std::string * names[dunedaq::dal::ClassMask::NumOfClasses] = {
+      &dunedaq::dal::Application::s_class_name,
+      &dunedaq::dal::BaseApplication::s_class_name,
+      &dunedaq::dal::Component::s_class_name,
+      &dunedaq::dal::Computer::s_class_name,
+      &dunedaq::dal::ComputerSet::s_class_name,
+      &dunedaq::dal::InfrastructureApplication::s_class_name,
+      &dunedaq::dal::InfrastructureBase::s_class_name,
+      &dunedaq::dal::Parameter::s_class_name,
+      &dunedaq::dal::Resource::s_class_name,
+      &dunedaq::dal::ResourceBase::s_class_name,
+      &dunedaq::dal::ResourceSet::s_class_name,
+      &dunedaq::dal::ResourceSetAND::s_class_name,
+      &dunedaq::dal::ResourceSetOR::s_class_name,
+      &dunedaq::dal::RunControlApplicationBase::s_class_name,
+      &dunedaq::dal::SW_ExternalPackage::s_class_name,
+      &dunedaq::dal::SW_Package::s_class_name,
+      &dunedaq::dal::SW_Repository::s_class_name,
+      &dunedaq::dal::Segment::s_class_name,
+      &dunedaq::dal::TemplateApplication::s_class_name,
+      &dunedaq::dal::TemplateSegment::s_class_name,
+      &dunedaq::dal::Variable::s_class_name,
+      &dunedaq::dal::VariableSet::s_class_name
+    };
+
+    return names[c];
+  }
+
+  // masks calculated for current generation
+
+  std::mutex s_masks_mutex;
+  std::unordered_map<const std::string *, uint32_t> s_masks;
+  uint32_t s_masks_generation = 0;
+
+}
+
+
+uint32_t
+dunedaq::dal::ClassMask::update(Entry& e, const dunedaq::oksdbinterfaces::DalObject * obj)
+{
+  const std::string * key = &obj->class_name();
+  const uint32_t generation = s_generation.load(std::memory_order_relaxed);
+
+  uint32_t mask = 0;
+
+  {
+    std::lock_guard<std::mutex> scoped_lock(s_masks_mutex);
+
+    if (s_masks_generation != generation)
+      {
+        s_masks.clear();
+        s_masks_generation = generation;
+      }
+
+    auto it = s_masks.find(key);
+
+    if (it != s_masks.end())
+      {
+        mask = it->second;
+      }
+    else
+      {
+        for (uint8_t i = 0; i < NumOfClasses; ++i)
+          if (obj->castable(*get_name(static_cast<Class>(i))))
+            mask |= (1U << i);
+
+        s_masks.emplace(key, mask);
+
+        TLOG_DEBUG(6) << "calculate mask 0x" << std::hex << mask << std::dec << " of class \'" << *key << '\'';
+      }
+  }
+
+  e.m_key = key;
+  e.m_generation = generation;
+  e.m_mask = mask;
+
+  return mask;
+}
@@ -8,6 +8,9 @@
 #include "dal/OnlineSegment.hpp"
 #include "dal/util.hpp"
 #include "dal/disabled-components.hpp"
+#include "dal/class-mask.hpp"
+#include "dal/instrumentation.hpp"
+#include "dal/trace.hpp"
 
 #include "logging/Logging.hpp"
 
@@ -68,19 +71,19 @@ dunedaq::dal::DisabledComponents::reset() noexcept
 bool
 dunedaq::dal::DisabledComponents::is_enabled(const dunedaq::dal::Component * c)
 {
-  if (const dunedaq::dal::Segment * seg = c->cast<dunedaq::dal::Segment>())
+  if (const dunedaq::dal::Segment * seg = dunedaq::dal::ClassMask::cast<dunedaq::dal::Segment>(c))
     {
       if (dunedaq::dal::SegConfig * conf = seg->get_seg_config(false, true))
         {
           return !conf->is_disabled();
         }
     }
-  else if (const dunedaq::dal::BaseApplication * app = c->cast<dunedaq::dal::BaseApplication>())
+  else if (const dunedaq::dal::BaseApplication * app = dunedaq::dal::ClassMask::cast<dunedaq::dal::BaseApplication>(c))
     {
       if (const dunedaq::dal::AppConfig * conf = app->get_app_config(true))
         {
           const dunedaq::dal::BaseApplication * base = conf->get_base_app();
-          if (base != app && is_enabled_short(base->cast<dunedaq::dal::Component>()) == false)
+          if (base != app && is_enabled_short(dunedaq::dal::ClassMask::cast<dunedaq::dal::Component>(base)) == false)
             return false;
         }
     }
@@ -101,7 +104,7 @@ dunedaq::dal::Partition::set_disabled(const std::set<const dunedaq::dal::Compone
 
   m_disabled_components.reset();
 
-  m_app_config.__clear();
+  m_app_config.__reset_tree();
 }
 
 void
@@ -116,7 +119,7 @@ dunedaq::dal::Partition::set_enabled(const std::set<const dunedaq::dal::Componen
 
   m_disabled_components.reset();
 
-  m_app_config.__clear();
+  m_app_config.__reset_tree();
 }
 
 void
@@ -124,9 +127,7 @@ dunedaq::dal::DisabledComponents::disable_children(const dunedaq::dal::ResourceS
 {
   for (auto & i : rs.get_Contains())
     {
-      // FIXME 2022-04-22: implement efficient castable() method working with pointers
-      //if (i->castable(&dunedaq::dal::TemplateApplication::s_class_name) == false)
-      if (i->cast<dunedaq::dal::TemplateApplication>() == nullptr)
+      if (dunedaq::dal::ClassMask::castable<dunedaq::dal::TemplateApplication>(i) == false)
         {
           TLOG_DEBUG(6) <<  "disable resource " << i << " because it's parent resource-set " << &rs << " is disabled" ;
           disable(*i);
@@ -136,7 +137,7 @@ dunedaq::dal::DisabledComponents::disable_children(const dunedaq::dal::ResourceS
           TLOG_DEBUG(6) <<  "do not disable template resource application " << i << " (it's parent resource-set " << &rs << " is disabled)" ;
         }
 
-      if (const dunedaq::dal::ResourceSet * rs2 = i->cast<dunedaq::dal::ResourceSet>())
+      if (const dunedaq::dal::ResourceSet * rs2 = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(i))
         {
           disable_children(*rs2);
         }
@@ -148,9 +149,7 @@ dunedaq::dal::DisabledComponents::disable_children(const dunedaq::dal::Segment&
 {
   for (auto & i : s.get_Resources())
     {
-      // FIXME 2022-04-22: implement efficient castable() method working with pointers
-      //if (i->castable(&dunedaq::dal::TemplateApplication::s_class_name) == false)
-      if (i->cast<dunedaq::dal::TemplateApplication>() == nullptr)
+      if (dunedaq::dal::ClassMask::castable<dunedaq::dal::TemplateApplication>(i) == false)
         {
           TLOG_DEBUG(6) <<  "disable resource " << i << " because it's parent segment " << &s << " is disabled" ;
           disable(*i);
@@ -160,7 +159,7 @@ dunedaq::dal::DisabledComponents::disable_children(const dunedaq::dal::Segment&
           TLOG_DEBUG(6) <<  "do not disable template resource application " << i << " (it's parent segment " << &s << " is disabled)" ;
         }
 
-      if (const dunedaq::dal::ResourceSet * rs = i->cast<dunedaq::dal::ResourceSet>())
+      if (const dunedaq::dal::ResourceSet * rs = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(i))
         {
           disable_children(*rs);
         }
@@ -198,11 +197,11 @@ static void fill(
   dunedaq::dal::TestCircularDependency& cd_fuse
 )
 {
-  if (const dunedaq::dal::ResourceSetAND * r1 = rs.cast<dunedaq::dal::ResourceSetAND>())
+  if (const dunedaq::dal::ResourceSetAND * r1 = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSetAND>(&rs))
     {
       rs_and.push_back(r1);
     }
-  else if (const dunedaq::dal::ResourceSetOR * r2 = rs.cast<dunedaq::dal::ResourceSetOR>())
+  else if (const dunedaq::dal::ResourceSetOR * r2 = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSetOR>(&rs))
     {
       rs_or.push_back(r2);
     }
@@ -210,7 +209,7 @@ static void fill(
   for (auto & i : rs.get_Contains())
     {
       dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, i);
-      if (const dunedaq::dal::ResourceSet * rs2 = i->cast<dunedaq::dal::ResourceSet>())
+      if (const dunedaq::dal::ResourceSet * rs2 = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(i))
         {
           fill(*rs2, rs_or, rs_and, cd_fuse);
         }
@@ -230,7 +229,7 @@ static void fill(
   for (auto & i : s.get_Resources())
     {
       dunedaq::dal::AddTestOnCircularDependency add_fuse_test(cd_fuse, i);
-      if (const dunedaq::dal::ResourceSet * rs = i->cast<dunedaq::dal::ResourceSet>())
+      if (const dunedaq::dal::ResourceSet * rs = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(i))
         {
           fill(*rs, rs_or, rs_and, cd_fuse);
         }
@@ -261,7 +260,7 @@ static void fill(
       // NOTE: normally application may not be ResourceSet, but for some "exotic" cases put this code
       for (auto &a : p.get_OnlineInfrastructureApplications())
         {
-          if (const dunedaq::dal::ResourceSet * rs = a->cast<dunedaq::dal::ResourceSet>())
+          if (const dunedaq::dal::ResourceSet * rs = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(a))
             {
               fill(*rs, rs_or, rs_and, cd_fuse);
             }
@@ -280,19 +279,25 @@ static void fill(
 bool
 dunedaq::dal::Component::disabled(const dunedaq::dal::Partition& partition, bool skip_check) const
 {
+  DAL_INSTRUMENT_SCOPE(Disabled);
+
   // fill disabled (e.g. after partition changes)
 
   if (partition.m_disabled_components.size() == 0)
     {
       if (partition.get_Disabled().empty() && partition.m_disabled_components.m_user_disabled.empty())
         {
+          DAL_INSTRUMENT_HIT(Disabled);
           return false;  // the partition has no disabled components
         }
       else
         {
+          DAL_INSTRUMENT_MISS(Disabled);
+          DAL_TRACE_SPAN("disabled", partition.UID());
+
           // get two lists of all partition's resource-set-or and resource-set-and
           // also test any circular dependencies between segments and resource sets
-          dunedaq::dal::TestCircularDependency cd_fuse("component \'is-disabled\' status", &partition);
+          dunedaq::dal::TestCircularDependency cd_fuse("component \'is-disabled\' status", &partition, dunedaq::dal::is_dependency_graph_validated(partition));
           std::vector<const dunedaq::dal::ResourceSetOR *> rs_or;
           std::vector<const dunedaq::dal::ResourceSetAND *> rs_and;
           fill(partition, rs_or, rs_and, cd_fuse);
@@ -330,11 +335,11 @@ dunedaq::dal::Component::disabled(const dunedaq::dal::Partition& partition, bool
                 {
                   partition.m_disabled_components.disable(*i);
 
-                  if (const dunedaq::dal::ResourceSet * rs = i->cast<dunedaq::dal::ResourceSet>())
+                  if (const dunedaq::dal::ResourceSet * rs = dunedaq::dal::ClassMask::cast<dunedaq::dal::ResourceSet>(i))
                     {
                       partition.m_disabled_components.disable_children(*rs);
                     }
-                  else if (const dunedaq::dal::Segment * seg = i->cast<dunedaq::dal::Segment>())
+                  else if (const dunedaq::dal::Segment * seg = dunedaq::dal::ClassMask::cast<dunedaq::dal::Segment>(i))
                     {
                       partition.m_disabled_components.disable_children(*seg);
                     }
@@ -395,6 +400,8 @@ dunedaq::dal::Component::disabled(const dunedaq::dal::Partition& partition, bool
 
               if (partition.m_disabled_components.size() == num)
                 {
+                  DAL_INSTRUMENT_OBJECTS(Disabled, num);
+
                   TLOG_DEBUG(6) <<  "after " << count << " iteration(s) auto-disabling algorithm found no newly disabled sets, exiting loop ..." ;
                   break;
                 }
@@ -409,6 +416,10 @@ dunedaq::dal::Component::disabled(const dunedaq::dal::Partition& partition, bool
             }
         }
     }
+  else
+    {
+      DAL_INSTRUMENT_HIT(Disabled);
+    }
 
   bool result(skip_check ? !partition.m_disabled_components.is_enabled_short(this) : !partition.m_disabled_components.is_enabled(this));
   TLOG_DEBUG( 6) <<  "disabled(" << this << ") returns " << std::boolalpha << result  ;
@@ -0,0 +1,94 @@
+//
+//  FILE: dal/src/environment-source.cpp
+//
+//  Contains implementation of the process environment used by the DAL algorithms.
+//
+
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "logging/Logging.hpp"
+
+#include "dal/environment-source.hpp"
+
+
+extern char ** environ;
+
+namespace {
+
+  std::atomic<uint64_t> s_next_id(1);
+
+  std::mutex s_mutex;
+  std::shared_ptr<const dunedaq::dal::EnvironmentSource> s_default;
+
+  thread_local std::shared_ptr<const dunedaq::dal::EnvironmentSource> s_scope;
+
+}
+
+
+dunedaq::dal::EnvironmentSource::EnvironmentSource(Values&& values) :
+  m_values(std::move(values)),
+  m_id(s_next_id++)
+{
+}
+
+std::shared_ptr<const dunedaq::dal::EnvironmentSource>
+dunedaq::dal::EnvironmentSource::snapshot()
+{
+  Values values;
+
+  for (char ** p = environ; p && *p; ++p)
+    if (const char * eq = strchr(*p, '='))
+      values.emplace(std::string(*p, eq - *p), std::string(eq + 1));
+
+  TLOG_DEBUG(2) << "take snapshot of process environment with " << values.size() << " variables";
+
+  return create(std::move(values));
+}
+
+std::shared_ptr<const dunedaq::dal::EnvironmentSource>
+dunedaq::dal::EnvironmentSource::create(Values values)
+{
+  return std::shared_ptr<const EnvironmentSource>(new EnvironmentSource(std::move(values)));
+}
+
+std::shared_ptr<const dunedaq::dal::EnvironmentSource>
+dunedaq::dal::EnvironmentSource::get()
+{
+  if (s_scope)
+    return s_scope;
+
+  if (std::shared_ptr<const EnvironmentSource> source = std::atomic_load(&s_default))
+    return source;
+
+  // take the snapshot once, when the default is used first time
+
+  std::lock_guard<std::mutex> scoped_lock(s_mutex);
+
+  if (!std::atomic_load(&s_default))
+    std::atomic_store(&s_default, snapshot());
+
+  return std::atomic_load(&s_default);
+}
+
+void
+dunedaq::dal::EnvironmentSource::set_default(std::shared_ptr<const EnvironmentSource> source)
+{
+  std::atomic_store(&s_default, std::move(source));
+}
+
+dunedaq::dal::EnvironmentSource::Scope::Scope(std::shared_ptr<const EnvironmentSource> source) :
+  m_previous(std::move(s_scope))
+{
+  s_scope = std::move(source);
+}
+
+dunedaq::dal::EnvironmentSource::Scope::~Scope()
+{
+  s_scope = std::move(m_previous);
+}
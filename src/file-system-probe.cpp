@@ -0,0 +1,252 @@
+//
+//  FILE: dal/src/file-system-probe.cpp
+//
+//  Contains implementation of the cache of directory listings.
+//
+
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "logging/Logging.hpp"
+
+#include "dal/file-system-probe.hpp"
+
+
+namespace {
+
+  struct Directory
+  {
+    bool m_exists = false;
+    bool m_listed = false;       // false, if the directory exists but cannot be read (e.g. search permission only)
+    struct timespec m_mtime = {0, 0};
+    std::unordered_set<std::string> m_files;
+
+    bool
+    modified(const struct stat * buf) const
+    {
+      if (buf == nullptr || !S_ISDIR(buf->st_mode))
+        return m_exists;
+
+      return (!m_exists || buf->st_mtim.tv_sec != m_mtime.tv_sec || buf->st_mtim.tv_nsec != m_mtime.tv_nsec);
+    }
+  };
+
+  std::shared_mutex s_mutex;
+  std::unordered_map<std::string, std::shared_ptr<const Directory>> s_directories;
+  std::atomic<uint64_t> s_version(0);
+  std::atomic<int64_t> s_last_check(0);
+
+  int64_t
+  now()
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+    // the directory is stat'ed before it is read, so a modification made meantime is detected by next check;
+    // the symbolic links are stat'ed, so the dangling ones are not listed (a change of link target is not detected)
+
+  std::shared_ptr<const Directory>
+  read_directory(const std::string& path)
+  {
+    auto d = std::make_shared<Directory>();
+
+    struct stat buf;
+
+    if (stat(path.c_str(), &buf) == 0 && S_ISDIR(buf.st_mode))
+      {
+        d->m_exists = true;
+        d->m_mtime = buf.st_mtim;
+
+        if (DIR * dir = opendir(path.c_str()))
+          {
+            d->m_listed = true;
+
+            while (struct dirent * e = readdir(dir))
+              if (strcmp(e->d_name, ".") && strcmp(e->d_name, ".."))
+                {
+                  struct stat target;
+
+                  if ((e->d_type == DT_LNK || e->d_type == DT_UNKNOWN) && fstatat(dirfd(dir), e->d_name, &target, 0) != 0)
+                    continue;
+
+                  d->m_files.emplace(e->d_name);
+                }
+
+            closedir(dir);
+          }
+      }
+
+    TLOG_DEBUG(6) << "read directory \'" << path << "\': " << d->m_files.size() << " entries";
+
+    return d;
+  }
+
+    // drop listings of directories modified since they were read; only one thread checks per interval
+
+  void
+  check()
+  {
+    int64_t last = s_last_check.load();
+    const int64_t t = now();
+
+    if (t - last < static_cast<int64_t>(dunedaq::dal::FileSystemProbe::check_interval) || !s_last_check.compare_exchange_strong(last, t))
+      return;
+
+    std::vector<std::pair<std::string, std::shared_ptr<const Directory>>> dirs;
+
+    {
+      std::shared_lock<std::shared_mutex> lock(s_mutex);
+      dirs.assign(s_directories.begin(), s_directories.end());
+    }
+
+    std::vector<std::string> modified;
+
+    for (const auto& x : dirs)
+      {
+        struct stat buf;
+        if (x.second->modified(stat(x.first.c_str(), &buf) == 0 ? &buf : nullptr))
+          modified.push_back(x.first);
+      }
+
+    if (!modified.empty())
+      {
+        std::unique_lock<std::shared_mutex> lock(s_mutex);
+
+        for (const auto& x : modified)
+          {
+            TLOG_DEBUG(6) << "directory \'" << x << "\' was modified";
+            s_directories.erase(x);
+          }
+
+        s_version++;
+      }
+  }
+
+}
+
+
+bool
+dunedaq::dal::FileSystemProbe::exists(const std::string& path)
+{
+  const std::string::size_type idx = path.rfind('/');
+
+  // not an absolute path to a file; test it directly
+
+  if (idx == std::string::npos || idx == path.size() - 1)
+    {
+      struct stat buf;
+      return (stat(path.c_str(), &buf) == 0);
+    }
+
+  check();
+
+  const std::string dir_name(idx == 0 ? std::string("/") : path.substr(0, idx));
+  const std::string file_name(path.substr(idx + 1));
+
+  std::shared_ptr<const Directory> dir;
+
+  {
+    std::shared_lock<std::shared_mutex> lock(s_mutex);
+
+    auto it = s_directories.find(dir_name);
+
+    if (it != s_directories.end())
+      dir = it->second;
+  }
+
+  if (!dir)
+    {
+      dir = read_directory(dir_name);
+
+      std::unique_lock<std::shared_mutex> lock(s_mutex);
+      s_directories.emplace(dir_name, dir);
+    }
+
+  // test unreadable directory directly
+
+  if (dir->m_exists && !dir->m_listed)
+    {
+      struct stat buf;
+      return (stat(path.c_str(), &buf) == 0);
+    }
+
+  return (dir->m_files.find(file_name) != dir->m_files.end());
+}
+
+std::size_t
+dunedaq::dal::FileSystemProbe::remove_empty_directories(std::vector<std::string>& paths)
+{
+  check();
+
+  std::vector<std::shared_ptr<const Directory>> dirs(paths.size());
+  std::vector<std::size_t> missing;
+
+  {
+    std::shared_lock<std::shared_mutex> lock(s_mutex);
+
+    for (std::size_t i = 0; i < paths.size(); ++i)
+      {
+        auto it = s_directories.find(paths[i]);
+
+        if (it != s_directories.end())
+          dirs[i] = it->second;
+        else
+          missing.push_back(i);
+      }
+  }
+
+  if (!missing.empty())
+    {
+      for (const auto& i : missing)
+        dirs[i] = read_directory(paths[i]);
+
+      std::unique_lock<std::shared_mutex> lock(s_mutex);
+
+      for (const auto& i : missing)
+        s_directories.emplace(paths[i], dirs[i]);
+    }
+
+  std::size_t num = 0;
+
+  // keep unreadable directories, since their files still can be found
+
+  for (std::size_t i = 0; i < paths.size(); ++i)
+    if (dirs[i]->m_files.empty() == false || (dirs[i]->m_exists && !dirs[i]->m_listed))
+      {
+        if (num != i)
+          paths[num] = std::move(paths[i]);
+        num++;
+      }
+
+  const std::size_t removed = paths.size() - num;
+
+  paths.resize(num);
+
+  return removed;
+}
+
+void
+dunedaq::dal::FileSystemProbe::refresh() noexcept
+{
+  std::unique_lock<std::shared_mutex> lock(s_mutex);
+  s_directories.clear();
+  s_version++;
+}
+
+uint64_t
+dunedaq::dal::FileSystemProbe::get_version()
+{
+  check();
+  return s_version.load();
+}
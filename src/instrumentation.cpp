@@ -0,0 +1,167 @@
+//
+//  FILE: dal/src/instrumentation.cpp
+//
+//  Contains implementation of counters and timers of the DAL hot paths.
+//
+
+#include <stdlib.h>
+
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+#include "dal/instrumentation.hpp"
+
+
+dunedaq::dal::Instrumentation::AtomicCounters dunedaq::dal::Instrumentation::s_counters[NumOfProbes];
+thread_local uint32_t dunedaq::dal::Instrumentation::s_depth[NumOfProbes];
+
+thread_local uint32_t dunedaq::dal::Instrumentation::s_track_allocations;
+thread_local uint64_t dunedaq::dal::Instrumentation::s_allocations;
+thread_local uint64_t dunedaq::dal::Instrumentation::s_allocated_bytes;
+
+
+#ifdef DAL_INSTRUMENTATION
+
+  // Replace global allocation functions to count allocations of threads with AllocationScope.
+  // The array and nothrow forms of the standard library call these ones.
+
+void *
+operator new(size_t size)
+{
+  dunedaq::dal::Instrumentation::count_allocation(size);
+
+  if (void * p = malloc(size ? size : 1))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+void *
+operator new(size_t size, std::align_val_t al)
+{
+  dunedaq::dal::Instrumentation::count_allocation(size);
+
+  const size_t alignment = static_cast<size_t>(al);
+
+  if (void * p = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void * p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void * p, size_t) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void * p, std::align_val_t) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void * p, size_t, std::align_val_t) noexcept
+{
+  free(p);
+}
+
+#endif
+
+
+bool
+dunedaq::dal::Instrumentation::is_enabled()
+{
+#ifdef DAL_INSTRUMENTATION
+  return true;
+#else
+  return false;
+#endif
+}
+
+const char *
+dunedaq::dal::Instrumentation::get_name(Probe probe)
+{
+  static const char * names[NumOfProbes] = {
+    "get_segment",
+    "disabled",
+    "get_parents",
+    "get_parameters",
+    "get_paths",
+    "environment",
+    "substitute_variables",
+    "add_classpath"
+  };
+
+  return (probe < NumOfProbes ? names[probe] : "unknown");
+}
+
+std::vector<dunedaq::dal::Instrumentation::Counters>
+dunedaq::dal::Instrumentation::get_snapshot()
+{
+  std::vector<Counters> out;
+  out.reserve(NumOfProbes);
+
+  for (uint8_t i = 0; i < NumOfProbes; ++i)
+    out.push_back(
+      Counters {
+        get_name(static_cast<Probe>(i)),
+        s_counters[i].m_calls.load(std::memory_order_relaxed),
+        s_counters[i].m_time.load(std::memory_order_relaxed),
+        s_counters[i].m_hits.load(std::memory_order_relaxed),
+        s_counters[i].m_misses.load(std::memory_order_relaxed),
+        s_counters[i].m_objects.load(std::memory_order_relaxed),
+        s_counters[i].m_allocations.load(std::memory_order_relaxed),
+        s_counters[i].m_allocated_bytes.load(std::memory_order_relaxed)
+      }
+    );
+
+  return out;
+}
+
+void
+dunedaq::dal::Instrumentation::reset()
+{
+  for (auto& x : s_counters)
+    {
+      x.m_calls.store(0, std::memory_order_relaxed);
+      x.m_time.store(0, std::memory_order_relaxed);
+      x.m_hits.store(0, std::memory_order_relaxed);
+      x.m_misses.store(0, std::memory_order_relaxed);
+      x.m_objects.store(0, std::memory_order_relaxed);
+      x.m_allocations.store(0, std::memory_order_relaxed);
+      x.m_allocated_bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+void
+dunedaq::dal::Instrumentation::print(std::ostream& s)
+{
+  if (is_enabled() == false)
+    {
+      s << "the dal library is built without instrumentation (use DAL_INSTRUMENTATION option)\n";
+      return;
+    }
+
+  s << std::left << std::setw(24) << "probe" << std::right << std::setw(12) << "calls" << std::setw(14) << "time ms" << std::setw(12) << "avg us"
+    << std::setw(12) << "hits" << std::setw(12) << "misses" << std::setw(12) << "objects" << std::setw(12) << "allocs" << std::setw(14) << "alloc KB" << std::endl;
+
+  for (const auto& x : get_snapshot())
+    {
+      if (x.m_calls == 0 && x.m_hits == 0 && x.m_misses == 0)
+        continue;
+
+      s << std::left << std::setw(24) << x.m_name << std::right << std::setw(12) << x.m_calls << std::fixed << std::setprecision(3)
+        << std::setw(14) << x.m_time / 1000000. << std::setw(12) << (x.m_calls ? x.m_time / 1000. / x.m_calls : 0.) << std::defaultfloat << std::setprecision(6)
+        << std::setw(12) << x.m_hits << std::setw(12) << x.m_misses << std::setw(12) << x.m_objects
+        << std::setw(12) << x.m_allocations << std::setw(14) << x.m_allocated_bytes / 1024 << std::endl;
+    }
+}
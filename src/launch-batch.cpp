@@ -0,0 +1,130 @@
+//
+//  FILE: dal/src/launch-batch.cpp
+//
+//  Contains implementation of encoder of resolved applications launch descriptions.
+//
+
+#include "ers/ers.hpp"
+#include "logging/Logging.hpp"
+
+#include "dal/BaseApplication.hpp"
+#include "dal/Computer.hpp"
+#include "dal/Tag.hpp"
+
+#include "dal/launch-batch.hpp"
+#include "dal/util.hpp"
+
+
+namespace {
+
+  void
+  put32(std::string& out, uint32_t v)
+  {
+    const char b[4] = { static_cast<char>(v), static_cast<char>(v >> 8), static_cast<char>(v >> 16), static_cast<char>(v >> 24) };
+    out.append(b, sizeof(b));
+  }
+
+}
+
+
+void
+dunedaq::dal::LaunchBatchWriter::add_string(const std::string& s, std::vector<uint32_t>& out)
+{
+  auto it = m_index.find(s);
+
+  if (it == m_index.end())
+    {
+      it = m_index.emplace(s, static_cast<uint32_t>(m_strings.size())).first;
+      m_strings.append(s);
+    }
+
+  out.push_back(it->second);
+  out.push_back(s.size());
+}
+
+void
+dunedaq::dal::LaunchBatchWriter::add_list(const std::vector<std::string>& values)
+{
+  m_apps.push_back(m_refs.size() / LaunchBatchReader::reference_size);
+  m_apps.push_back(values.size());
+
+  for (const auto& x : values)
+    add_string(x, m_refs);
+}
+
+void
+dunedaq::dal::LaunchBatchWriter::add(const std::string& name, const std::string& host, const std::vector<std::string>& backup_hosts, const std::string& tag,
+                                     const std::vector<std::string>& program_names, const std::map<std::string, std::string>& environment,
+                                     const std::string& start_args, const std::string& restart_args)
+{
+  add_string(name, m_apps);
+  add_string(host, m_apps);
+  add_string(tag, m_apps);
+  add_string(start_args, m_apps);
+  add_string(restart_args, m_apps);
+
+  add_list(backup_hosts);
+  add_list(program_names);
+
+  m_apps.push_back(m_refs.size() / LaunchBatchReader::reference_size);
+  m_apps.push_back(environment.size());
+
+  for (const auto& x : environment)
+    {
+      add_string(x.first, m_refs);
+      add_string(x.second, m_refs);
+    }
+}
+
+void
+dunedaq::dal::LaunchBatchWriter::add(const dunedaq::dal::BaseApplication& app)
+{
+  std::map<std::string, std::string> environment;
+  std::vector<std::string> program_names;
+  std::string start_args, restart_args;
+
+  const dunedaq::dal::Tag * tag = app.get_info(environment, program_names, start_args, restart_args);
+
+  std::vector<std::string> backup_hosts;
+
+  for (const auto& x : app.get_backup_hosts())
+    backup_hosts.push_back(x->UID());
+
+  const dunedaq::dal::Computer * host = app.get_host();
+
+  add(app.UID(), (host ? host->UID() : ""), backup_hosts, (tag ? tag->UID() : ""), program_names, environment, start_args, restart_args);
+}
+
+std::string
+dunedaq::dal::LaunchBatchWriter::encode() const
+{
+  const uint32_t num_of_apps = get_num_of_applications();
+  const uint32_t num_of_refs = m_refs.size() / LaunchBatchReader::reference_size;
+  const uint64_t size = LaunchBatchReader::get_size(num_of_apps, num_of_refs, m_strings.size());
+
+  if (size > UINT32_MAX)
+    throw dunedaq::dal::AlgorithmError(ERS_HERE, "the size of launch batch exceeds 4 GB");
+
+  std::string out;
+  out.reserve(size);
+
+  out.append(LaunchBatchReader::magic, sizeof(LaunchBatchReader::magic));
+  put32(out, LaunchBatchReader::format_version);
+  put32(out, num_of_apps);
+  put32(out, num_of_refs);
+  put32(out, m_strings.size());
+  put32(out, size);
+  put32(out, 0);
+
+  for (const auto& x : m_apps)
+    put32(out, x);
+
+  for (const auto& x : m_refs)
+    put32(out, x);
+
+  out.append(m_strings);
+
+  TLOG_DEBUG(2) << "encode launch batch with " << num_of_apps << " applications, " << num_of_refs << " references and " << m_strings.size() << " bytes of strings (" << size << " bytes)";
+
+  return out;
+}
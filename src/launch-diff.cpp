@@ -0,0 +1,160 @@
+//
+//  FILE: dal/src/launch-diff.cpp
+//
+//  Contains implementation of comparison of applications launch descriptions.
+//
+
+#include <map>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+
+#include "logging/Logging.hpp"
+
+#include "dal/launch-diff.hpp"
+#include "dal/launch-plan.hpp"
+
+
+namespace {
+
+  std::string
+  join(const std::vector<std::string>& values, char separator)
+  {
+    std::string out;
+
+    for (const auto& x : values)
+      {
+        if (!out.empty())
+          out.push_back(separator);
+
+        out.append(x);
+      }
+
+    return out;
+  }
+
+  std::string
+  get_host(const dunedaq::dal::LaunchPlan& plan, const dunedaq::dal::LaunchPlan::ApplicationRecord& app)
+  {
+    if (app.m_host == dunedaq::dal::LaunchPlan::npos)
+      return "";
+
+    return std::string(plan.get_string(plan.get_host(app.m_host).m_id));
+  }
+
+  void
+  compare(std::vector<dunedaq::dal::AppLaunchDiff::Field>& fields, const char * name, std::string&& old_value, std::string&& new_value)
+  {
+    if (old_value != new_value)
+      fields.push_back(dunedaq::dal::AppLaunchDiff::Field{name, std::move(old_value), std::move(new_value)});
+  }
+
+  void
+  compare(std::vector<dunedaq::dal::AppLaunchDiff::Field>& fields, const std::map<std::string, std::string>& from, const std::map<std::string, std::string>& to)
+  {
+    // both maps are sorted, merge them
+
+    auto i = from.begin();
+    auto j = to.begin();
+
+    while (i != from.end() || j != to.end())
+      {
+        if (j == to.end() || (i != from.end() && i->first < j->first))
+          {
+            fields.push_back(dunedaq::dal::AppLaunchDiff::Field{"environment:" + i->first, i->second, ""});
+            ++i;
+          }
+        else if (i == from.end() || j->first < i->first)
+          {
+            fields.push_back(dunedaq::dal::AppLaunchDiff::Field{"environment:" + j->first, "", j->second});
+            ++j;
+          }
+        else
+          {
+            if (i->second != j->second)
+              fields.push_back(dunedaq::dal::AppLaunchDiff::Field{"environment:" + i->first, i->second, j->second});
+
+            ++i;
+            ++j;
+          }
+      }
+  }
+
+}
+
+
+std::vector<dunedaq::dal::AppLaunchDiff>
+dunedaq::dal::compare_launch_plans(const LaunchPlan& from, const LaunchPlan& to)
+{
+  std::vector<AppLaunchDiff> result;
+
+  std::unordered_map<std::string_view, uint32_t> from_apps;
+  from_apps.reserve(from.get_num_of_applications());
+
+  for (uint32_t i = 0; i < from.get_num_of_applications(); ++i)
+    from_apps.emplace(from.get_string(from.get_application(i).m_id), i);
+
+  std::vector<bool> found(from.get_num_of_applications(), false);
+
+  for (uint32_t i = 0; i < to.get_num_of_applications(); ++i)
+    {
+      const LaunchPlan::ApplicationRecord& b(to.get_application(i));
+      const std::string_view id(to.get_string(b.m_id));
+
+      auto it = from_apps.find(id);
+
+      if (it == from_apps.end())
+        {
+          result.push_back(AppLaunchDiff{std::string(id), AppLaunchDiff::Added, {}});
+          continue;
+        }
+
+      found[it->second] = true;
+
+      const LaunchPlan::ApplicationRecord& a(from.get_application(it->second));
+
+      std::vector<AppLaunchDiff::Field> fields;
+
+      compare(fields, "host", get_host(from, a), get_host(to, b));
+      compare(fields, "backup-hosts", join(from.get_backup_hosts(a), ' '), join(to.get_backup_hosts(b), ' '));
+      compare(fields, "program-names", join(from.get_program_names(a), ':'), join(to.get_program_names(b), ':'));
+      compare(fields, "start-args", std::string(from.get_string(a.m_start_args)), std::string(to.get_string(b.m_start_args)));
+      compare(fields, "restart-args", std::string(from.get_string(a.m_restart_args)), std::string(to.get_string(b.m_restart_args)));
+      compare(fields, from.get_environment(a), to.get_environment(b));
+
+      if (!fields.empty())
+        result.push_back(AppLaunchDiff{std::string(id), AppLaunchDiff::Changed, std::move(fields)});
+    }
+
+  for (uint32_t i = 0; i < from.get_num_of_applications(); ++i)
+    if (found[i] == false)
+      result.push_back(AppLaunchDiff{std::string(from.get_string(from.get_application(i).m_id)), AppLaunchDiff::Removed, {}});
+
+  TLOG_DEBUG(1) << "compare launch plans " << from.get_file_name() << " and " << to.get_file_name() << ": " << result.size() << " applications differ";
+
+  return result;
+}
+
+
+void
+dunedaq::dal::AppLaunchDiff::print(std::ostream& s) const
+{
+  switch (m_status)
+    {
+      case Added:
+        s << "+ application " << m_id << " is added\n";
+        break;
+
+      case Removed:
+        s << "- application " << m_id << " is removed\n";
+        break;
+
+      case Changed:
+        s << "* application " << m_id << " is changed:\n";
+
+        for (const auto& x : m_fields)
+          s << "   - " << x.m_name << ":\n      old: \"" << x.m_old_value << "\"\n      new: \"" << x.m_new_value << "\"\n";
+
+        break;
+    }
+}
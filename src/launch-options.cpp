@@ -0,0 +1,110 @@
+//
+//  FILE: dal/src/launch-options.cpp
+//
+//  Contains implementation of the optional modes of application's get_info() algorithms.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dal/launch-options.hpp"
+
+
+namespace {
+
+    // the option is enabled by non-empty value of variable, except "0"
+
+  uint32_t
+  get_option(const char * name, dunedaq::dal::LaunchOptions::Option option)
+  {
+    const char * value = getenv(name);
+    return ((value && *value && strcmp(value, "0")) ? static_cast<uint32_t>(option) : 0);
+  }
+
+  std::string
+  get_dir(const char * name)
+  {
+    const char * value = getenv(name);
+    return (value ? value : "");
+  }
+
+}
+
+std::string dunedaq::dal::LaunchOptions::s_library_view_dir(get_dir("DAL_LIBRARY_VIEW_DIR"));
+std::atomic<uint32_t> dunedaq::dal::LaunchOptions::s_options(get_option("DAL_PRUNE_PATHS", PrunePaths) | get_option("DAL_LIBRARY_VIEW_DIR", LibraryView) | get_option("DAL_RESOLVE_PROGRAMS", ResolvePrograms));
+std::atomic<uint64_t> dunedaq::dal::LaunchOptions::s_paths(0);
+std::atomic<uint64_t> dunedaq::dal::LaunchOptions::s_pruned(0);
+std::atomic<uint64_t> dunedaq::dal::LaunchOptions::s_pruned_bytes(0);
+
+
+void
+dunedaq::dal::LaunchOptions::set(Option option, bool value)
+{
+  if (value)
+    s_options.fetch_or(option);
+  else
+    s_options.fetch_and(~option);
+}
+
+void
+dunedaq::dal::LaunchOptions::set_library_view_dir(const std::string& dir)
+{
+  s_library_view_dir = dir;
+  set(LibraryView, !dir.empty());
+}
+
+std::string
+dunedaq::dal::LaunchOptions::get_state()
+{
+  std::string s;
+
+  if (is_set(PrunePaths))
+    s.append("prune-paths ");
+
+  if (is_set(LibraryView))
+    s.append("library-view=").append(s_library_view_dir).push_back(' ');
+
+  if (is_set(ResolvePrograms))
+    s.append("resolve-programs ");
+
+  if (!s.empty())
+    s.pop_back();
+
+  return s;
+}
+
+dunedaq::dal::LaunchOptions::PathsReport
+dunedaq::dal::LaunchOptions::get_paths_report()
+{
+  return PathsReport{s_paths.load(), s_pruned.load(), s_pruned_bytes.load()};
+}
+
+void
+dunedaq::dal::LaunchOptions::reset()
+{
+  s_paths.store(0);
+  s_pruned.store(0);
+  s_pruned_bytes.store(0);
+}
+
+void
+dunedaq::dal::LaunchOptions::print(std::ostream& s)
+{
+  if (is_set(PrunePaths))
+    {
+      const PathsReport r(get_paths_report());
+
+      s << "pruned " << r.m_pruned << " of " << r.m_paths << " PATH and LD_LIBRARY_PATH directories (" << r.m_pruned_bytes << " bytes)";
+
+      if (r.m_paths)
+        s << ", " << (r.m_pruned * 100 / r.m_paths) << '%';
+
+      s << std::endl;
+    }
+
+  if (is_set(LibraryView))
+    s << "shared libraries views directory: " << s_library_view_dir << std::endl;
+
+  if (is_set(ResolvePrograms))
+    s << "resolve program names" << std::endl;
+}
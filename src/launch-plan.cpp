@@ -0,0 +1,613 @@
+//
+//  FILE: dal/src/launch-plan.cpp
+//
+//  Contains implementation of precompiled launch plan snapshot file.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+#include "ers/ers.hpp"
+#include "logging/Logging.hpp"
+
+#include "oksdbinterfaces/Configuration.hpp"
+#include "okssystem/Host.hpp"
+
+#include "dal/Application.hpp"
+#include "dal/BaseApplication.hpp"
+#include "dal/Computer.hpp"
+#include "dal/CustomLifetimeApplicationBase.hpp"
+#include "dal/OnlineSegment.hpp"
+#include "dal/Partition.hpp"
+#include "dal/Segment.hpp"
+
+#include "dal/app-info-cache.hpp"
+#include "dal/environment-source.hpp"
+#include "dal/launch-options.hpp"
+#include "dal/launch-plan.hpp"
+#include "dal/partition-image.hpp"
+#include "dal/util.hpp"
+
+
+namespace dunedaq::dal {
+
+    // the layout of snapshot file is:
+    //   Header, SegmentRecord[], HostRecord[], ApplicationRecord[], StringRef[], char[]
+
+  namespace {
+
+    const char s_magic[8] = { 'D', 'A', 'L', 'P', 'L', 'A', 'N', '\0' };
+    const uint32_t s_byte_order = 0x01020304;
+
+      // process environment read by add_front_partition_environment()
+
+    const char * s_env_inputs[] = { "TDAQ_DB_REPOSITORY", "TDAQ_DB_USER_REPOSITORY", "OKS_REPOSITORY_MAPPING_DIR" };
+
+    struct Header
+    {
+      char m_magic[8];
+      uint32_t m_format_version;
+      uint32_t m_byte_order;
+      LaunchPlan::StringRef m_partition;
+      LaunchPlan::StringRef m_config_version;
+      uint32_t m_substituted;
+      LaunchPlan::StringRef m_inputs;
+      uint32_t m_num_of_segments;
+      uint32_t m_num_of_hosts;
+      uint32_t m_num_of_apps;
+      uint32_t m_num_of_refs;
+      uint32_t m_strings_size;
+      uint64_t m_file_size;
+    };
+
+    uint64_t
+    get_size(uint64_t num_of_segments, uint64_t num_of_hosts, uint64_t num_of_apps, uint64_t num_of_refs, uint64_t strings_size)
+    {
+      return (
+        sizeof(Header) +
+        num_of_segments * sizeof(LaunchPlan::SegmentRecord) +
+        num_of_hosts * sizeof(LaunchPlan::HostRecord) +
+        num_of_apps * sizeof(LaunchPlan::ApplicationRecord) +
+        num_of_refs * sizeof(LaunchPlan::StringRef) +
+        strings_size
+      );
+    }
+
+    class StringPool
+    {
+    public:
+
+      LaunchPlan::StringRef
+      add(const std::string& s)
+      {
+        auto it = m_index.find(s);
+
+        if (it != m_index.end())
+          return it->second;
+
+        LaunchPlan::StringRef ref { static_cast<uint32_t>(m_data.size()), static_cast<uint32_t>(s.size()) };
+        m_data.append(s);
+        m_index.emplace(s, ref);
+
+        return ref;
+      }
+
+      const std::string&
+      data() const
+      {
+        return m_data;
+      }
+
+    private:
+
+      std::string m_data;
+      std::unordered_map<std::string, LaunchPlan::StringRef> m_index;
+    };
+
+  }
+
+} // namespace dunedaq::dal
+
+
+std::string
+dunedaq::dal::LaunchPlan::make_inputs(const std::string& database)
+{
+  const std::shared_ptr<const dunedaq::dal::EnvironmentSource> source(dunedaq::dal::EnvironmentSource::get());
+
+  // the configuration uses TDAQ_DB, when the database name is empty
+
+  std::string inputs("database=");
+
+  if (!database.empty())
+    inputs.append(database);
+  else if (const char * s = getenv("TDAQ_DB"))
+    inputs.append(s);
+
+  // the segments without computers use the local host (see Segment::get_hosts())
+
+  inputs.append("\nhost=");
+  inputs.append(OksSystem::LocalHost::full_local_name());
+
+  // distinguish undefined and empty variables
+  for (const auto& x : s_env_inputs)
+    {
+      inputs.push_back('\n');
+      inputs.append(x);
+
+      if (const std::string * value = source->find(x))
+        {
+          inputs.push_back('=');
+          inputs.append(*value);
+        }
+    }
+
+  // the get_info() results depend on enabled launch options
+
+  inputs.append("\noptions=");
+  inputs.append(dunedaq::dal::LaunchOptions::get_state());
+
+  return inputs;
+}
+
+
+std::string
+dunedaq::dal::LaunchPlan::get_file_name(const std::string& dir, const std::string& partition, const std::string& config_version, bool substituted, const std::string& inputs)
+{
+  std::string name(dir);
+
+  if (!name.empty() && name.back() != '/')
+    name.push_back('/');
+
+  name.append(partition);
+  name.push_back('.');
+
+  // the configuration version is a GIT SHA, but do not allow it to change directory
+  for (const auto& c : config_version)
+    name.push_back(c == '/' ? '_' : c);
+
+  name.append(substituted ? ".s" : ".r");
+
+  // 64-bit FNV-1a hash of inputs
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  for (const auto& c : inputs)
+    hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+
+  char buf[18];
+  snprintf(buf, sizeof(buf), ".%016lx", static_cast<unsigned long>(hash));
+  name.append(buf);
+
+  name.append(".dal-plan");
+
+  return name;
+}
+
+
+void
+dunedaq::dal::LaunchPlan::write(const std::string& file_name, const dunedaq::dal::Partition& partition, const std::string& config_version, bool substituted, const std::string& inputs, dunedaq::dal::AppInfoCache * cache)
+{
+  StringPool strings;
+
+  std::vector<SegmentRecord> segments;
+  std::vector<HostRecord> hosts;
+  std::vector<ApplicationRecord> apps;
+  std::vector<StringRef> refs;
+
+  // the image is compiled with the segments tree
+
+  const std::shared_ptr<const dunedaq::dal::PartitionImage> image_ptr(partition.get_image()); // keeps the image arrays alive on reload
+  const dunedaq::dal::PartitionImage& image(*image_ptr);
+
+  segments.reserve(image.get_num_of_segments());
+
+  for (uint32_t i = 0; i < image.get_num_of_segments(); ++i)
+    {
+      SegmentRecord r {};
+      r.m_id = strings.add(image.get_segments()[i]->UID());
+      r.m_parent = (image.get_segment_parents()[i] == PartitionImage::npos ? npos : image.get_segment_parents()[i]);
+      r.m_enabled = image.get_segment_enabled()[i];
+      r.m_templated = image.get_segment_templated()[i];
+      segments.push_back(r);
+    }
+
+  // store all hosts described by the configuration followed by hosts used by applications (if any is not found)
+
+  std::unordered_map<const dunedaq::dal::Computer *, uint32_t> hosts_idx;
+
+  auto add_host = [&](const dunedaq::dal::Computer * h)
+    {
+      auto it = hosts_idx.emplace(h, hosts.size());
+
+      if (it.second)
+        {
+          HostRecord r;
+          r.m_id = strings.add(h->UID());
+          r.m_rlogin = strings.add(h->get_RLogin());
+          r.m_hw_tag = strings.add(h->get_HW_Tag());
+          hosts.push_back(r);
+        }
+
+      return it.first->second;
+    };
+
+    {
+      std::vector<const dunedaq::dal::Computer*> all_hosts;
+      const_cast<dunedaq::oksdbinterfaces::Configuration&>(partition.configuration()).get(all_hosts);
+
+      for (const auto& h : all_hosts)
+        add_host(h);
+    }
+
+  apps.reserve(image.get_num_of_applications());
+
+  for (uint32_t i = 0; i < image.get_num_of_applications(); ++i)
+    {
+      const dunedaq::dal::BaseApplication * app = image.get_applications()[i];
+      const dunedaq::dal::BaseApplication * base = app->get_base_app();
+
+      std::vector<std::string> file_names;
+      std::map<std::string, std::string> environment;
+      std::string start_args, restart_args;
+
+      if (cache)
+        cache->get_info(*app, environment, file_names, start_args, restart_args);
+      else
+        app->get_info(environment, file_names, start_args, restart_args);
+
+      std::ostringstream base_name;
+      base_name << base;
+
+      ApplicationRecord r {};
+      r.m_id = strings.add(app->UID());
+      r.m_base_app_id = strings.add(base->UID());
+      r.m_base_app_name = strings.add(base_name.str());
+      r.m_class_name = strings.add(app->class_name());
+
+      if (const dunedaq::dal::CustomLifetimeApplicationBase * ca = base->cast<dunedaq::dal::CustomLifetimeApplicationBase>())
+        r.m_lifetime = strings.add(ca->get_Lifetime());
+      else
+        r.m_lifetime = strings.add("");
+
+      r.m_start_args = strings.add(start_args);
+      r.m_restart_args = strings.add(restart_args);
+      r.m_segment = image.get_application_segments()[i];
+      r.m_host = (app->get_host() ? add_host(app->get_host()) : npos);
+
+      r.m_program_names = refs.size();
+      r.m_num_of_program_names = file_names.size();
+
+      for (const auto& x : file_names)
+        refs.push_back(strings.add(x));
+
+      r.m_environment = refs.size();
+      r.m_num_of_environment = environment.size();
+
+      for (const auto& x : environment)
+        {
+          refs.push_back(strings.add(x.first));
+          refs.push_back(strings.add(x.second));
+        }
+
+      const std::vector<const dunedaq::dal::Computer *> backup_hosts(app->get_backup_hosts());
+
+      r.m_backup_hosts = refs.size();
+      r.m_num_of_backup_hosts = backup_hosts.size();
+
+      for (const auto& x : backup_hosts)
+        refs.push_back(strings.add(x->UID()));
+
+      r.m_templated = (base->cast<dunedaq::dal::Application>() == nullptr);
+      r.m_restartable = (
+        base->get_IfExitsUnexpectedly() == dunedaq::dal::BaseApplication::IfExitsUnexpectedly::Restart ||
+        base->get_IfFailsToStart() == dunedaq::dal::BaseApplication::IfFailsToStart::Restart
+      );
+
+      apps.push_back(r);
+    }
+
+  Header header {};
+  memcpy(header.m_magic, s_magic, sizeof(s_magic));
+  header.m_format_version = format_version;
+  header.m_byte_order = s_byte_order;
+  header.m_partition = strings.add(partition.UID());
+  header.m_config_version = strings.add(config_version);
+  header.m_substituted = substituted;
+  header.m_inputs = strings.add(inputs);
+  header.m_num_of_segments = segments.size();
+  header.m_num_of_hosts = hosts.size();
+  header.m_num_of_apps = apps.size();
+  header.m_num_of_refs = refs.size();
+  header.m_strings_size = strings.data().size();
+  header.m_file_size = get_size(segments.size(), hosts.size(), apps.size(), refs.size(), strings.data().size());
+
+  // write temporary file and rename it
+
+  std::ostringstream tmp_name;
+  tmp_name << file_name << ".tmp." << getpid();
+
+    {
+      std::ofstream f(tmp_name.str(), std::ios::binary | std::ios::trunc);
+
+      if (!f)
+        throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("cannot open temporary file \'") + tmp_name.str() + "\' for writing: " + strerror(errno));
+
+      f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      f.write(reinterpret_cast<const char *>(segments.data()), segments.size() * sizeof(SegmentRecord));
+      f.write(reinterpret_cast<const char *>(hosts.data()), hosts.size() * sizeof(HostRecord));
+      f.write(reinterpret_cast<const char *>(apps.data()), apps.size() * sizeof(ApplicationRecord));
+      f.write(reinterpret_cast<const char *>(refs.data()), refs.size() * sizeof(StringRef));
+      f.write(strings.data().data(), strings.data().size());
+      f.close();
+
+      if (!f)
+        {
+          unlink(tmp_name.str().c_str());
+          throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("failed to write temporary file \'") + tmp_name.str() + '\'');
+        }
+    }
+
+  if (rename(tmp_name.str().c_str(), file_name.c_str()) != 0)
+    {
+      const int error = errno;
+      unlink(tmp_name.str().c_str());
+      throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("cannot rename temporary file: ") + strerror(error));
+    }
+
+  TLOG_DEBUG(1) << "write launch plan " << file_name << " of partition " << partition.UID() << " with " << segments.size() << " segments, " << apps.size() << " applications and " << hosts.size() << " hosts (" << header.m_file_size << " bytes)";
+}
+
+
+std::unique_ptr<dunedaq::dal::LaunchPlan>
+dunedaq::dal::LaunchPlan::open(const std::string& file_name, const std::string& partition, const std::string& config_version, bool substituted, const std::string& inputs)
+{
+  struct stat buf;
+
+  if (stat(file_name.c_str(), &buf) != 0 && errno == ENOENT)
+    {
+      TLOG_DEBUG(1) << "there is no launch plan file " << file_name;
+      return nullptr;
+    }
+
+  auto plan = std::make_unique<LaunchPlan>(file_name);
+
+  if (plan->get_partition() != partition)
+    throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("the file is produced for partition \'") + std::string(plan->get_partition()) + '\'');
+
+  if (plan->get_config_version() != config_version)
+    throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("the file is produced for configuration version \'") + std::string(plan->get_config_version()) + '\'');
+
+  if (plan->get_substituted() != substituted)
+    throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, substituted ? "the database parameters are not substituted" : "the database parameters are substituted");
+
+  if (plan->get_inputs() != inputs)
+    throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("the file is produced for other database or process environment:\n") + std::string(plan->get_inputs()));
+
+  return plan;
+}
+
+
+dunedaq::dal::LaunchPlan::LaunchPlan(const std::string& file_name) :
+  m_file_name(file_name),
+  m_data(nullptr),
+  m_size(0)
+{
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+
+  if (fd < 0)
+    throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("cannot open file: ") + strerror(errno));
+
+  struct stat buf;
+
+  if (fstat(fd, &buf) != 0)
+    {
+      const int error = errno;
+      ::close(fd);
+      throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("cannot stat file: ") + strerror(error));
+    }
+
+  if (static_cast<size_t>(buf.st_size) < sizeof(Header))
+    {
+      ::close(fd);
+      throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, "the file is too short");
+    }
+
+  m_size = buf.st_size;
+  m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  ::close(fd);
+
+  if (m_data == MAP_FAILED)
+    {
+      m_data = nullptr;
+      throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, std::string("cannot map file: ") + strerror(errno));
+    }
+
+  try
+    {
+      const Header * header = static_cast<const Header *>(m_data);
+
+      if (memcmp(header->m_magic, s_magic, sizeof(s_magic)) != 0)
+        throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, "the file is not a launch plan");
+
+      if (header->m_byte_order != s_byte_order)
+        throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, "the file is produced on platform with different byte order");
+
+      if (header->m_format_version != format_version)
+        {
+          std::ostringstream text;
+          text << "the file format version " << header->m_format_version << " is not supported (expected " << format_version << ')';
+          throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, text.str());
+        }
+
+      if (header->m_file_size != m_size || get_size(header->m_num_of_segments, header->m_num_of_hosts, header->m_num_of_apps, header->m_num_of_refs, header->m_strings_size) != m_size)
+        throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, "the file size does not match to its header (truncated file?)");
+
+      m_num_of_segments = header->m_num_of_segments;
+      m_num_of_hosts = header->m_num_of_hosts;
+      m_num_of_apps = header->m_num_of_apps;
+
+      const char * p = static_cast<const char *>(m_data) + sizeof(Header);
+
+      m_segments = reinterpret_cast<const SegmentRecord *>(p);
+      p += m_num_of_segments * sizeof(SegmentRecord);
+
+      m_hosts = reinterpret_cast<const HostRecord *>(p);
+      p += m_num_of_hosts * sizeof(HostRecord);
+
+      m_apps = reinterpret_cast<const ApplicationRecord *>(p);
+      p += m_num_of_apps * sizeof(ApplicationRecord);
+
+      m_refs = reinterpret_cast<const StringRef *>(p);
+      p += header->m_num_of_refs * sizeof(StringRef);
+
+      m_strings = p;
+
+      // validate all references, so that accessors do not need to check them
+
+      const uint64_t strings_size = header->m_strings_size;
+      const uint64_t num_of_refs = header->m_num_of_refs;
+
+      auto check_string = [&](const StringRef& r)
+        {
+          if (static_cast<uint64_t>(r.m_offset) + r.m_size > strings_size)
+            throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, "bad string reference");
+        };
+
+      check_string(header->m_partition);
+      check_string(header->m_config_version);
+      check_string(header->m_inputs);
+
+      for (uint32_t i = 0; i < m_num_of_segments; ++i)
+        {
+          check_string(m_segments[i].m_id);
+
+          if (m_segments[i].m_parent != npos && m_segments[i].m_parent >= i)
+            throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, "bad segment parent reference");
+        }
+
+      for (uint32_t i = 0; i < m_num_of_hosts; ++i)
+        {
+          check_string(m_hosts[i].m_id);
+          check_string(m_hosts[i].m_rlogin);
+          check_string(m_hosts[i].m_hw_tag);
+        }
+
+      for (uint32_t i = 0; i < num_of_refs; ++i)
+        check_string(m_refs[i]);
+
+      for (uint32_t i = 0; i < m_num_of_apps; ++i)
+        {
+          const ApplicationRecord& a(m_apps[i]);
+
+          check_string(a.m_id);
+          check_string(a.m_base_app_id);
+          check_string(a.m_base_app_name);
+          check_string(a.m_class_name);
+          check_string(a.m_lifetime);
+          check_string(a.m_start_args);
+          check_string(a.m_restart_args);
+
+          if (a.m_segment >= m_num_of_segments || (a.m_host != npos && a.m_host >= m_num_of_hosts) ||
+              static_cast<uint64_t>(a.m_program_names) + a.m_num_of_program_names > num_of_refs ||
+              static_cast<uint64_t>(a.m_environment) + 2 * static_cast<uint64_t>(a.m_num_of_environment) > num_of_refs ||
+              static_cast<uint64_t>(a.m_backup_hosts) + a.m_num_of_backup_hosts > num_of_refs)
+            throw dunedaq::dal::BadLaunchPlan(ERS_HERE, file_name, "bad application record");
+        }
+    }
+  catch (...)
+    {
+      munmap(m_data, m_size);
+      m_data = nullptr;
+      throw;
+    }
+
+  TLOG_DEBUG(1) << "map launch plan " << file_name << " with " << m_num_of_segments << " segments, " << m_num_of_apps << " applications and " << m_num_of_hosts << " hosts (" << m_size << " bytes)";
+}
+
+
+dunedaq::dal::LaunchPlan::~LaunchPlan()
+{
+  if (m_data)
+    munmap(m_data, m_size);
+}
+
+
+std::string_view
+dunedaq::dal::LaunchPlan::get_partition() const
+{
+  return get_string(static_cast<const Header *>(m_data)->m_partition);
+}
+
+std::string_view
+dunedaq::dal::LaunchPlan::get_config_version() const
+{
+  return get_string(static_cast<const Header *>(m_data)->m_config_version);
+}
+
+bool
+dunedaq::dal::LaunchPlan::get_substituted() const
+{
+  return static_cast<const Header *>(m_data)->m_substituted;
+}
+
+std::string_view
+dunedaq::dal::LaunchPlan::get_inputs() const
+{
+  return get_string(static_cast<const Header *>(m_data)->m_inputs);
+}
+
+std::vector<std::string>
+dunedaq::dal::LaunchPlan::get_program_names(const ApplicationRecord& app) const
+{
+  std::vector<std::string> out;
+  out.reserve(app.m_num_of_program_names);
+
+  for (uint32_t i = 0; i < app.m_num_of_program_names; ++i)
+    out.emplace_back(get_string(m_refs[app.m_program_names + i]));
+
+  return out;
+}
+
+std::map<std::string, std::string>
+dunedaq::dal::LaunchPlan::get_environment(const ApplicationRecord& app) const
+{
+  std::map<std::string, std::string> out;
+
+  for (uint32_t i = 0; i < app.m_num_of_environment; ++i)
+    out.emplace_hint(out.end(), get_string(m_refs[app.m_environment + 2 * i]), get_string(m_refs[app.m_environment + 2 * i + 1]));
+
+  return out;
+}
+
+std::vector<std::string>
+dunedaq::dal::LaunchPlan::get_backup_hosts(const ApplicationRecord& app) const
+{
+  std::vector<std::string> out;
+  out.reserve(app.m_num_of_backup_hosts);
+
+  for (uint32_t i = 0; i < app.m_num_of_backup_hosts; ++i)
+    out.emplace_back(get_string(m_refs[app.m_backup_hosts + i]));
+
+  return out;
+}
+
+uint32_t
+dunedaq::dal::LaunchPlan::find_application(std::string_view id) const
+{
+  for (uint32_t i = 0; i < m_num_of_apps; ++i)
+    if (get_string(m_apps[i].m_id) == id)
+      return i;
+
+  return npos;
+}
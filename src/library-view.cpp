@@ -0,0 +1,218 @@
+//
+//  FILE: dal/src/library-view.cpp
+//
+//  Contains implementation of the local view directories of shared libraries.
+//
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "logging/Logging.hpp"
+
+#include "dal/file-system-probe.hpp"
+#include "dal/launch-options.hpp"
+#include "dal/library-view.hpp"
+#include "dal/util.hpp"
+
+
+namespace {
+
+    // 64-bit FNV-1a hash
+
+  class Hash
+  {
+  public:
+
+    void
+    add(const void * data, size_t len)
+    {
+      for (size_t i = 0; i < len; ++i)
+        m_h = (m_h ^ static_cast<const uint8_t *>(data)[i]) * 0x100000001b3ULL;
+    }
+
+    void
+    add(const std::string& s)
+    {
+      add(s.c_str(), s.size() + 1);
+    }
+
+    std::string
+    str() const
+    {
+      char buf[17];
+      snprintf(buf, sizeof(buf), "%016lx", static_cast<unsigned long>(m_h));
+      return buf;
+    }
+
+  private:
+
+    uint64_t m_h = 0xcbf29ce484222325ULL;
+  };
+
+
+    // shared libraries are files named "libname.so" or "libname.so.version"
+
+  bool
+  is_shared_library(const char * name)
+  {
+    const char * p = strstr(name, ".so");
+    return (p && (p[3] == 0 || p[3] == '.'));
+  }
+
+
+  void
+  remove_directory(const std::string& path)
+  {
+    if (DIR * dir = opendir(path.c_str()))
+      {
+        while (struct dirent * e = readdir(dir))
+          if (strcmp(e->d_name, ".") && strcmp(e->d_name, ".."))
+            unlink((path + '/' + e->d_name).c_str());
+
+        closedir(dir);
+      }
+
+    rmdir(path.c_str());
+  }
+
+
+    // create view in temporary directory and rename it; another process may create the same view meantime
+
+  void
+  create_view(const std::string& path, const std::vector<std::string>& dirs)
+  {
+    std::ostringstream tmp_name;
+    tmp_name << path << ".tmp." << getpid() << '.' << std::this_thread::get_id();
+
+    const std::string tmp(tmp_name.str());
+
+    if (mkdir(tmp.c_str(), 0777) != 0)
+      throw dunedaq::dal::BadLibraryView(ERS_HERE, path, std::string("cannot create directory \'") + tmp + "\': " + strerror(errno));
+
+    std::unordered_set<std::string> names;
+
+    for (const auto& d : dirs)
+      if (DIR * dir = opendir(d.c_str()))
+        {
+          while (struct dirent * e = readdir(dir))
+            if (is_shared_library(e->d_name) && names.emplace(e->d_name).second)
+              {
+                const std::string link(tmp + '/' + e->d_name);
+
+                if (symlink((d + '/' + e->d_name).c_str(), link.c_str()) != 0)
+                  {
+                    const int error = errno;
+                    closedir(dir);
+                    remove_directory(tmp);
+                    throw dunedaq::dal::BadLibraryView(ERS_HERE, path, std::string("cannot create symbolic link \'") + link + "\': " + strerror(error));
+                  }
+              }
+
+          closedir(dir);
+        }
+
+    if (rename(tmp.c_str(), path.c_str()) != 0)
+      {
+        const int error = errno;
+        remove_directory(tmp);
+
+        if (error != EEXIST && error != ENOTEMPTY)
+          throw dunedaq::dal::BadLibraryView(ERS_HERE, path, std::string("cannot rename directory \'") + tmp + "\': " + strerror(error));
+      }
+
+    TLOG_DEBUG(2) << "create view \'" << path << "\' with " << names.size() << " shared libraries from " << dirs.size() << " directories";
+  }
+
+
+  std::mutex s_mutex;
+  std::unordered_map<std::string, std::pair<uint64_t, std::string>> s_views;
+
+}
+
+
+std::string
+dunedaq::dal::LibraryView::get(const std::vector<std::string>& dirs, const std::string& tag)
+{
+  const std::string& root(dunedaq::dal::LaunchOptions::get_library_view_dir());
+
+  std::string key(tag);
+
+  for (const auto& x : dirs)
+    {
+      key.push_back('\0');
+      key.append(x);
+    }
+
+  // load directories into the probe, so their modifications change its version
+
+  {
+    std::vector<std::string> v(dirs);
+    dunedaq::dal::FileSystemProbe::remove_empty_directories(v);
+  }
+
+  const uint64_t version = dunedaq::dal::FileSystemProbe::get_version();
+
+  {
+    std::lock_guard<std::mutex> scoped_lock(s_mutex);
+
+    auto it = s_views.find(key);
+
+    if (it != s_views.end() && it->second.first == version)
+      return it->second.second;
+  }
+
+  // build name of view from tag, directories and their modification times
+
+  Hash dirs_hash, stamp_hash;
+
+  for (const auto& x : dirs)
+    {
+      dirs_hash.add(x);
+
+      struct stat buf;
+
+      if (stat(x.c_str(), &buf) == 0 && S_ISDIR(buf.st_mode))
+        stamp_hash.add(&buf.st_mtim, sizeof(buf.st_mtim));
+      else
+        stamp_hash.add("", 1);
+    }
+
+  std::string path(root);
+  path.push_back('/');
+  path.append(tag);
+  path.push_back('-');
+  path.append(dirs_hash.str());
+  path.push_back('-');
+  path.append(stamp_hash.str());
+
+  struct stat buf;
+
+  if (stat(path.c_str(), &buf) != 0 || !S_ISDIR(buf.st_mode))
+    {
+      if (mkdir(root.c_str(), 0777) != 0 && errno != EEXIST)
+        throw dunedaq::dal::BadLibraryView(ERS_HERE, path, std::string("cannot create directory \'") + root + "\': " + strerror(errno));
+
+      create_view(path, dirs);
+    }
+  else
+    {
+      TLOG_DEBUG(5) << "use existing view \'" << path << '\'';
+    }
+
+  std::lock_guard<std::mutex> scoped_lock(s_mutex);
+  s_views[key] = std::make_pair(version, path);
+
+  return path;
+}
@@ -1,5 +1,25 @@
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "oksdbinterfaces/Configuration.hpp"
 #include "oksdbinterfaces/DalObject.hpp"
 
+#include "dal/Application.hpp"
+#include "dal/BaseApplication.hpp"
+#include "dal/ComputerProgram.hpp"
+#include "dal/InfrastructureBase.hpp"
+#include "dal/OnlineSegment.hpp"
+#include "dal/Parameter.hpp"
+#include "dal/Partition.hpp"
+#include "dal/ResourceBase.hpp"
+#include "dal/ResourceSet.hpp"
+#include "dal/RunControlApplicationBase.hpp"
+#include "dal/SW_Package.hpp"
+#include "dal/SW_Repository.hpp"
+#include "dal/Segment.hpp"
+#include "dal/VariableSet.hpp"
+
 #include "test_circular_dependency.hpp"
 
 void
@@ -18,3 +38,216 @@ dunedaq::dal::TestCircularDependency::push(const dunedaq::oksdbinterfaces::DalOb
     throw dunedaq::dal::FoundCircularDependency(ERS_HERE, p_limit, p_goal, s.str());
   }
 }
+
+
+namespace {
+
+  // the edges followed by the recursive algorithms using TestCircularDependency
+
+  template<class T>
+    void
+    add_children(std::vector<const dunedaq::oksdbinterfaces::DalObject *>& out, const std::vector<const T *>& objs)
+    {
+      out.insert(out.end(), objs.begin(), objs.end());
+    }
+
+  void
+  get_children(const dunedaq::oksdbinterfaces::DalObject * obj, std::vector<const dunedaq::oksdbinterfaces::DalObject *>& out)
+  {
+    if (const dunedaq::dal::Segment * s = obj->cast<dunedaq::dal::Segment>())
+      {
+        add_children(out, s->get_Segments());
+        add_children(out, s->get_Resources());
+      }
+    else if (const dunedaq::dal::ResourceSet * rs = obj->cast<dunedaq::dal::ResourceSet>())
+      {
+        add_children(out, rs->get_Contains());
+      }
+    else if (const dunedaq::dal::SW_Package * p = obj->cast<dunedaq::dal::SW_Package>())
+      {
+        add_children(out, p->get_Uses());
+      }
+    else if (const dunedaq::dal::VariableSet * vs = obj->cast<dunedaq::dal::VariableSet>())
+      {
+        add_children(out, vs->get_Contains());
+      }
+  }
+
+  // the edges followed by the partition algorithms to reach the objects checked by CycleFinder
+
+  void
+  add_child(std::vector<const dunedaq::oksdbinterfaces::DalObject *>& out, const dunedaq::oksdbinterfaces::DalObject * obj)
+  {
+    if (obj)
+      out.push_back(obj);
+  }
+
+  void
+  get_used_objects(const dunedaq::oksdbinterfaces::DalObject * obj, std::vector<const dunedaq::oksdbinterfaces::DalObject *>& out)
+  {
+    if (const dunedaq::dal::Partition * part = obj->cast<dunedaq::dal::Partition>())
+      {
+        add_child(out, part->get_OnlineInfrastructure());
+        add_children(out, part->get_Segments());
+        add_children(out, part->get_OnlineInfrastructureApplications());
+        add_children(out, part->get_ProcessEnvironment());
+        add_children(out, part->get_Parameters());
+      }
+    else if (const dunedaq::dal::Segment * s = obj->cast<dunedaq::dal::Segment>())
+      {
+        add_children(out, s->get_Segments());
+        add_children(out, s->get_Resources());
+        add_children(out, s->get_Infrastructure());
+        add_children(out, s->get_Applications());
+        add_child(out, s->get_IsControlledBy());
+        add_children(out, s->get_ProcessEnvironment());
+        add_children(out, s->get_Parameters());
+      }
+    else if (const dunedaq::dal::ComputerProgram * c = obj->cast<dunedaq::dal::ComputerProgram>())
+      {
+        add_child(out, c->get_BelongsTo());
+        add_children(out, c->get_Uses());
+        add_children(out, c->get_ProcessEnvironment());
+      }
+    else if (const dunedaq::dal::SW_Package * p = obj->cast<dunedaq::dal::SW_Package>())
+      {
+        add_children(out, p->get_Uses());
+        add_children(out, p->get_ProcessEnvironment());
+      }
+    else if (const dunedaq::dal::VariableSet * vs = obj->cast<dunedaq::dal::VariableSet>())
+      {
+        add_children(out, vs->get_Contains());
+      }
+
+    // a resource may be an application or a set of resources
+
+    if (const dunedaq::dal::BaseApplication * a = obj->cast<dunedaq::dal::BaseApplication>())
+      {
+        add_child(out, a->get_Program());
+        add_children(out, a->get_Uses());
+        add_children(out, a->get_ProcessEnvironment());
+      }
+
+    if (const dunedaq::dal::ResourceSet * rs = obj->cast<dunedaq::dal::ResourceSet>())
+      {
+        add_children(out, rs->get_Contains());
+      }
+  }
+
+  class CycleFinder
+  {
+
+  public:
+
+    // returns the cycle found starting from given root, if any
+
+    std::string
+    check(const dunedaq::oksdbinterfaces::DalObject * root)
+    {
+      if (m_colour.emplace(root, Grey).second == false)
+        return "";
+
+      m_stack.push_back(Frame{root, m_children.size(), m_children.size()});
+      get_children(root, m_children);
+
+      while (!m_stack.empty())
+        {
+          Frame& f(m_stack.back());
+
+          if (f.m_next == m_children.size())
+            {
+              m_colour[f.m_obj] = Black;
+              m_children.resize(f.m_first);
+              m_stack.pop_back();
+              continue;
+            }
+
+          const dunedaq::oksdbinterfaces::DalObject * child = m_children[f.m_next++];
+
+          auto it = m_colour.emplace(child, Grey);
+
+          if (it.second)
+            {
+              m_stack.push_back(Frame{child, m_children.size(), m_children.size()});
+              get_children(child, m_children);
+            }
+          else if (it.first->second == Grey)
+            {
+              std::ostringstream s;
+
+              bool found = false;
+
+              for (const auto& x : m_stack)
+                {
+                  if (x.m_obj == child)
+                    found = true;
+
+                  if (found)
+                    s << x.m_obj << " -> ";
+                }
+
+              s << child;
+
+              return s.str();
+            }
+        }
+
+      return "";
+    }
+
+  private:
+
+    enum Colour : uint8_t { Grey, Black };
+
+    struct Frame
+    {
+      const dunedaq::oksdbinterfaces::DalObject * m_obj;
+      size_t m_first;    // index of first child in m_children
+      size_t m_next;     // index of next child in m_children
+    };
+
+    std::unordered_map<const dunedaq::oksdbinterfaces::DalObject *, Colour> m_colour;
+    std::vector<Frame> m_stack;
+    std::vector<const dunedaq::oksdbinterfaces::DalObject *> m_children;   // children of all objects on stack
+
+  };
+
+}
+
+
+std::string
+dunedaq::dal::find_dependency_cycle(const dunedaq::dal::Partition& p, std::unordered_set<const dunedaq::oksdbinterfaces::DalObject *> * reachable)
+{
+  // collect objects reachable from the partition; the walk does not need colours,
+  // since the cycles made of its edges are not followed by the fused algorithms
+
+  std::unordered_set<const dunedaq::oksdbinterfaces::DalObject *> visited;
+  std::vector<const dunedaq::oksdbinterfaces::DalObject *> used { &p };
+
+  visited.insert(&p);
+
+  for (size_t idx = 0; idx < used.size(); ++idx)
+    {
+      std::vector<const dunedaq::oksdbinterfaces::DalObject *> children;
+      get_used_objects(used[idx], children);
+
+      for (const auto& x : children)
+        if (visited.insert(x).second)
+          used.push_back(x);
+    }
+
+  CycleFinder finder;
+
+  for (const auto& x : used)
+    {
+      std::string cycle = finder.check(x);
+
+      if (!cycle.empty())
+        return cycle;
+    }
+
+  if (reachable)
+    reachable->swap(visited);
+
+  return "";
+}
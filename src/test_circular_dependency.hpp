@@ -2,28 +2,74 @@
 #define _daq_core_test_circular_dependency_H_
 
 
+#include <string>
+#include <unordered_set>
+
 #include "dal/util.hpp"
 
 namespace dunedaq {
   namespace oksdbinterfaces {
+    class Configuration;
     class DalObject;
   }
 }
 
 namespace dunedaq::dal {
 
+    class Partition;
+
+      /**
+       *  Run single depth-first search with colouring over the graphs of Segment (Segments, Resources),
+       *  ResourceSet (Contains), SW_Package (Uses) and VariableSet (Contains) objects reachable from the partition
+       *  (via its segments, applications, programs, software packages and parameters); the cycles of other
+       *  database objects are never walked by the partition algorithms and are not reported.
+       *  Return description of the first found cycle or empty string, if there are no cycles.
+       *  If the reachable pointer is not null, the checked objects are stored there.
+       */
+
+    std::string
+    find_dependency_cycle(const dunedaq::dal::Partition& p, std::unordered_set<const dunedaq::oksdbinterfaces::DalObject *> * reachable = nullptr);
+
+      /**
+       *  Return true, if the find_dependency_cycle() check passed for the database of the partition after last (re)load;
+       *  the check is run on first call after (re)load and the found cycle is reported once as an error.
+       */
+
+    bool
+    is_dependency_graph_validated(const dunedaq::dal::Partition& p);
+
+      /**
+       *  Return true, if the graph of the partition is validated (see above) and the object is reachable from the partition;
+       *  the algorithms starting from an arbitrary database object have to use this check.
+       */
+
+    bool
+    is_dependency_graph_validated(const dunedaq::dal::Partition& p, const dunedaq::oksdbinterfaces::DalObject * obj);
+
+
+      /**
+       *  The fuse limits depth of recursive walks over the objects graph. When the graph is validated
+       *  (see is_dependency_graph_validated()), the walks cannot loop and the fuse bookkeeping is skipped.
+       */
+
     class TestCircularDependency {
 
       friend class AddTestOnCircularDependency;
 
       public:
 
-        TestCircularDependency(const char * goal, const dunedaq::oksdbinterfaces::DalObject * first_object) :
-            p_goal(goal), p_index(0)
+        TestCircularDependency(const char * goal, const dunedaq::oksdbinterfaces::DalObject * first_object, bool validated = false) :
+            p_goal(goal), p_index(0), p_validated(validated)
         {
           p_objects[p_index++] = first_object;
         }
 
+        bool
+        is_validated() const
+        {
+          return p_validated;
+        }
+
 
       private:
 
@@ -43,6 +89,7 @@ namespace dunedaq::dal {
 
         const char * p_goal;
         unsigned int p_index;
+        const bool p_validated;
         const dunedaq::oksdbinterfaces::DalObject * p_objects[p_limit];
 
     };
@@ -51,8 +98,8 @@ namespace dunedaq::dal {
 
       public:
 
-        AddTestOnCircularDependency(TestCircularDependency& fuse, const dunedaq::oksdbinterfaces::DalObject * obj) : p_fuse(fuse) { p_fuse.push(obj); }
-        ~AddTestOnCircularDependency() { p_fuse.pop(); }
+        AddTestOnCircularDependency(TestCircularDependency& fuse, const dunedaq::oksdbinterfaces::DalObject * obj) : p_fuse(fuse) { if (!p_fuse.p_validated) p_fuse.push(obj); }
+        ~AddTestOnCircularDependency() { if (!p_fuse.p_validated) p_fuse.pop(); }
 
 
       private:
@@ -0,0 +1,207 @@
+//
+//  FILE: dal/src/trace.cpp
+//
+//  Contains implementation of the DAL algorithms tracer writing Chrome trace-event JSON file.
+//
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ers/ers.hpp"
+
+#include "dal/trace.hpp"
+#include "dal/util.hpp"
+
+
+namespace {
+
+  struct Event
+  {
+    const char * m_name;
+    std::string m_id;
+    uint64_t m_start;
+    uint64_t m_duration;
+  };
+
+    // the events of single thread; the mutex is only contended by flush()
+
+  struct Buffer
+  {
+    Buffer(uint32_t tid) :
+      m_tid(tid)
+    {
+    }
+
+    const uint32_t m_tid;
+    std::mutex m_mutex;
+    std::vector<Event> m_events;
+  };
+
+  const char *
+  get_file_name()
+  {
+    const char * name = getenv("DAL_TRACE_FILE");
+    return ((name && *name) ? name : nullptr);
+  }
+
+  const std::chrono::steady_clock::time_point s_start = std::chrono::steady_clock::now();
+
+    // buffers are owned by the registry, so events of finished threads are not lost
+
+  std::mutex s_buffers_mutex;
+  std::vector<std::shared_ptr<Buffer>> s_buffers;
+
+  thread_local std::shared_ptr<Buffer> s_buffer;
+
+  Buffer&
+  get_buffer()
+  {
+    if (!s_buffer)
+      {
+        std::lock_guard<std::mutex> lock(s_buffers_mutex);
+        s_buffer = std::make_shared<Buffer>(s_buffers.size() + 1);
+        s_buffers.push_back(s_buffer);
+      }
+
+    return *s_buffer;
+  }
+
+  void
+  print_string(std::ostream& s, const char * str)
+  {
+    s << '\"';
+
+    for (; *str; ++str)
+      {
+        const unsigned char c = *str;
+
+        if (c == '\"' || c == '\\')
+          s << '\\' << c;
+        else if (c < 0x20)
+          {
+            static const char hex[] = "0123456789abcdef";
+            s << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+          }
+        else
+          s << c;
+      }
+
+    s << '\"';
+  }
+
+  void
+  print_time(std::ostream& s, uint64_t ns)
+  {
+    // trace-event times are in microseconds
+
+    s << ns / 1000 << '.' << static_cast<char>('0' + ns / 100 % 10) << static_cast<char>('0' + ns / 10 % 10) << static_cast<char>('0' + ns % 10);
+  }
+
+    // write the file when the process exits normally
+
+  struct Writer
+  {
+    ~Writer()
+    {
+      if (dunedaq::dal::Trace::is_enabled())
+        {
+          try
+            {
+              dunedaq::dal::Trace::flush();
+            }
+          catch (ers::Issue& ex)
+            {
+              ers::error(ex);
+            }
+        }
+    }
+  } s_writer;
+
+}
+
+
+const bool dunedaq::dal::Trace::s_enabled = (get_file_name() != nullptr);
+const std::string dunedaq::dal::Trace::s_empty;
+
+
+uint64_t
+dunedaq::dal::Trace::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_start).count();
+}
+
+void
+dunedaq::dal::Trace::add(const char * name, const std::string& id, uint64_t start, uint64_t duration)
+{
+  Buffer& buffer(get_buffer());
+  std::lock_guard<std::mutex> lock(buffer.m_mutex);
+  buffer.m_events.push_back(Event{name, id, start, duration});
+}
+
+void
+dunedaq::dal::Trace::flush()
+{
+  const char * file_name = get_file_name();
+
+  if (!file_name)
+    return;
+
+  std::ofstream f(file_name);
+
+  if (!f)
+    throw dunedaq::dal::BadTraceFile(ERS_HERE, file_name, strerror(errno));
+
+  const pid_t pid = getpid();
+
+  std::lock_guard<std::mutex> lock(s_buffers_mutex);
+
+  f << "{\"traceEvents\":[\n";
+
+  bool first = true;
+
+  for (const auto& b : s_buffers)
+    {
+      std::lock_guard<std::mutex> buffer_lock(b->m_mutex);
+
+      if (!first)
+        f << ",\n";
+
+      first = false;
+
+      f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << b->m_tid << ",\"args\":{\"name\":\"thread " << b->m_tid << "\"}}";
+
+      for (const auto& e : b->m_events)
+        {
+          f << ",\n{\"name\":";
+          print_string(f, e.m_name);
+          f << ",\"cat\":\"dal\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << b->m_tid << ",\"ts\":";
+          print_time(f, e.m_start);
+          f << ",\"dur\":";
+          print_time(f, e.m_duration);
+
+          if (!e.m_id.empty())
+            {
+              f << ",\"args\":{\"id\":";
+              print_string(f, e.m_id.c_str());
+              f << '}';
+            }
+
+          f << '}';
+        }
+    }
+
+  f << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  f.close();
+
+  if (!f)
+    throw dunedaq::dal::BadTraceFile(ERS_HERE, file_name, "write failed");
+}
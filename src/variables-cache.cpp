@@ -0,0 +1,96 @@
+//
+//  FILE: dal/src/variables-cache.cpp
+//
+//  Contains implementation of the cache of process environment variables values.
+//
+
+#include <mutex>
+
+#include "dal/Parameter.hpp"
+#include "dal/Tag.hpp"
+#include "dal/Variable.hpp"
+#include "dal/VariableSet.hpp"
+
+#include "dal/class-mask.hpp"
+#include "dal/variables-cache.hpp"
+
+
+namespace {
+
+  void
+  flatten(dunedaq::dal::VariablesCache::Variables& out, const std::vector<const dunedaq::dal::Parameter *>& params, const dunedaq::dal::Tag * tag)
+  {
+    for (const auto& i : params)
+      if (const dunedaq::dal::Variable * var = dunedaq::dal::ClassMask::cast<dunedaq::dal::Variable>(i))
+        out.emplace_back(var->get_Name(), var->get_value(tag));
+      else if (const dunedaq::dal::VariableSet * vars = dunedaq::dal::ClassMask::cast<dunedaq::dal::VariableSet>(i))
+        flatten(out, vars->get_Contains(), tag);
+  }
+
+}
+
+
+std::shared_ptr<const std::string>
+dunedaq::dal::VariablesCache::get_value(const dunedaq::dal::Variable& var, const dunedaq::dal::Tag * tag)
+{
+  {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+    auto it = m_values.find(&var);
+
+    if (it != m_values.end())
+      if (std::shared_ptr<const std::string> value = find(it->second, tag))
+        return value;
+  }
+
+  std::shared_ptr<const std::string> value(std::make_shared<const std::string>(var.get_value(tag)));
+
+  std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+  TagMap<std::string>& values(m_values[&var]);
+
+  // the value can be added by another thread
+
+  if (std::shared_ptr<const std::string> v = find(values, tag))
+    return v;
+
+  values.emplace_back(tag, value);
+
+  return value;
+}
+
+std::shared_ptr<const dunedaq::dal::VariablesCache::Variables>
+dunedaq::dal::VariablesCache::get_variables(const dunedaq::dal::VariableSet& set, const dunedaq::dal::Tag * tag)
+{
+  {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+    auto it = m_sets.find(&set);
+
+    if (it != m_sets.end())
+      if (std::shared_ptr<const Variables> vars = find(it->second, tag))
+        return vars;
+  }
+
+  std::shared_ptr<Variables> vars(std::make_shared<Variables>());
+  flatten(*vars, set.get_Contains(), tag);
+
+  std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+  TagMap<Variables>& sets(m_sets[&set]);
+
+  if (std::shared_ptr<const Variables> v = find(sets, tag))
+    return v;
+
+  sets.emplace_back(tag, vars);
+
+  return vars;
+}
+
+void
+dunedaq::dal::VariablesCache::clear() noexcept
+{
+  std::unique_lock<std::shared_mutex> lock(m_mutex);
+  m_values.clear();
+  m_sets.clear();
+}